@@ -0,0 +1,140 @@
+/*
+  example10-fifo-frames
+
+  This example collects the accelerometer in frames of exactly 128 samples,
+    as e.g. an FFT would want them. The FIFO batch counter raises interrupt
+    one every 128 accelerometer samples, the interrupt handler only notes it
+    and the main loop reads the frame in one burst. The mean and the peak to
+    peak range of the Z axis are printed for every frame.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// Interrupt pin
+byte interrupt_pin = 10;
+
+// One frame plus room for the samples batched while it is read.
+#define FRAME_SAMPLES 128
+#define BUFFER_WORDS 192
+sfe_lsm_fifo_word_t frameBuffer[BUFFER_WORDS];
+
+float zData[FRAME_SAMPLES];
+uint16_t zCount = 0;
+
+void batchCounterISR()
+{
+    myLSM.fifoFrameISR();
+}
+
+void onAccel(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    if (zCount < FRAME_SAMPLES)
+        zData[zCount++] = sample->vector.zData;
+}
+
+void setup()
+{
+    pinMode(interrupt_pin, INPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 10 - FIFO Frames");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_480Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_4g);
+
+    // Only the accelerometer is batched, so every FIFO word is one sample.
+    myLSM.setAccelFifoBatchSet(LSM6DSV16X_XL_BATCHED_AT_480Hz);
+
+    myLSM.setFifoHandler(LSM_FIFO_ACCEL, onAccel);
+
+    attachInterrupt(digitalPinToInterrupt(interrupt_pin), batchCounterISR, RISING);
+
+    if (!myLSM.beginFifoFrames(frameBuffer, BUFFER_WORDS, FRAME_SAMPLES, LSM_PIN_ONE))
+    {
+        Serial.println("Could not start frame capture.");
+        while (1)
+            ;
+    }
+
+    Serial.println("Ready.");
+}
+
+void loop()
+{
+    uint16_t count;
+    const sfe_lsm_fifo_word_t *frame = myLSM.readFifoFrame(&count);
+
+    if (frame == nullptr)
+        return;
+
+    zCount = 0;
+    myLSM.getFifoDecoder().decode(frame, count);
+
+    if (zCount == 0)
+        return;
+
+    float mean = 0;
+    float minimum = zData[0];
+    float maximum = zData[0];
+
+    for (uint16_t i = 0; i < zCount; i++)
+    {
+        mean += zData[i];
+        if (zData[i] < minimum)
+            minimum = zData[i];
+        if (zData[i] > maximum)
+            maximum = zData[i];
+    }
+
+    Serial.print(zCount);
+    Serial.print(" samples, Z mean: ");
+    Serial.print(mean / zCount);
+    Serial.print(" peak to peak: ");
+    Serial.println(maximum - minimum);
+}
@@ -0,0 +1,139 @@
+/*
+  example11-fifo-capture
+
+  This example captures the accelerometer around a tap: 64 samples from
+    before the tap and 64 samples after it. Only the accelerometer is batched,
+    so every FIFO word is one sample. The tap interrupt wakes the main loop,
+    which switches the FIFO over, and the watermark interrupt then marks the
+    complete window. The window is read in one drain and the Z axis of every
+    sample is printed.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// Interrupt pin
+byte interrupt_pin = 10;
+
+#define PRE_SAMPLES 64
+#define POST_SAMPLES 64
+sfe_lsm_fifo_word_t window[PRE_SAMPLES + POST_SAMPLES];
+
+void captureISR()
+{
+    myLSM.fifoCaptureISR();
+}
+
+void onAccel(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    Serial.println(sample->vector.zData);
+}
+
+void setup()
+{
+    pinMode(interrupt_pin, INPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 11 - FIFO Capture");
+
+    Wire.begin();
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_480Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_8g);
+    myLSM.setAccelFifoBatchSet(LSM6DSV16X_XL_BATCHED_AT_480Hz);
+
+    // Single taps on the Z axis, see example 6 for the tap settings.
+    myLSM.enableTapInterrupt();
+
+    lsm6dsv16x_tap_detection_t directionEnable;
+    directionEnable.tap_x_en = 0;
+    directionEnable.tap_y_en = 0;
+    directionEnable.tap_z_en = 1;
+    myLSM.setTapDirection(directionEnable);
+
+    lsm6dsv16x_tap_thresholds_t tapThreshold;
+    tapThreshold.x = 0;
+    tapThreshold.y = 0;
+    tapThreshold.z = 2;
+    myLSM.setTapThresholds(tapThreshold);
+
+    lsm6dsv16x_tap_time_windows_t tapWindows;
+    tapWindows.shock = 1;
+    tapWindows.quiet = 1;
+    tapWindows.tap_gap = 7;
+    myLSM.setTapTimeWindows(tapWindows);
+
+    myLSM.setTapMode(LSM6DSV16X_ONLY_SINGLE);
+
+    myLSM.setFifoHandler(LSM_FIFO_ACCEL, onAccel);
+
+    attachInterrupt(digitalPinToInterrupt(interrupt_pin), captureISR, RISING);
+
+    if (!myLSM.armFifoCapture(LSM_CAPTURE_SINGLE_TAP, PRE_SAMPLES, POST_SAMPLES, LSM_PIN_ONE))
+    {
+        Serial.println("Could not arm the capture.");
+        while (1)
+            ;
+    }
+
+    Serial.println("Ready, tap the board.");
+}
+
+void loop()
+{
+    if (myLSM.serviceFifoCapture() != LSM_CAPTURE_DONE)
+        return;
+
+    uint16_t count = myLSM.readFifoCapture(window, PRE_SAMPLES + POST_SAMPLES);
+
+    Serial.print("Captured ");
+    Serial.print(count);
+    Serial.println(" samples, Z axis in mg:");
+
+    myLSM.getFifoDecoder().decode(window, count);
+
+    // Wait for the next tap.
+    myLSM.armFifoCapture(LSM_CAPTURE_SINGLE_TAP, PRE_SAMPLES, POST_SAMPLES, LSM_PIN_ONE);
+}
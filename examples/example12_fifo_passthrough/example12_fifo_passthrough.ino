@@ -0,0 +1,97 @@
+/*
+  example12-fifo-passthrough
+
+  This example sends the raw FIFO words to a host over the serial port without
+    converting them on the board. Accelerometer and gyroscope are batched at
+    1.92kHz; the main loop reads whatever the FIFO holds in one burst and
+    passes it to the framer, which wraps it in COBS encoded frames with a
+    sequence number and a CRC. The board does no floating point work per
+    sample, so the link is the only limit.
+
+  The output is binary, not for the Serial Monitor. Decode it on the host with
+    extras/fifo_frame_decode, e.g.
+
+        stty -F /dev/ttyACM0 raw 2000000
+        fifo_frame_decode /dev/ttyACM0
+
+  Both sensors at 1.92kHz make 3840 words of 7 bytes per second, about 27kB/s
+    with the framing, which needs a native USB port or a UART running at
+    460800 baud or more.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+SfeLSMFifoFramer framer;
+
+void setup()
+{
+    Serial.begin(2000000);
+    while (!Serial)
+    {
+    }
+
+    Wire.begin();
+    Wire.setClock(1000000);
+
+    // Nothing but frames goes out on the serial port, so failures just stop here.
+    if (!myLSM.begin())
+    {
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_1920Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_4g);
+    myLSM.setGyroDataRate(LSM6DSV16X_ODR_AT_1920Hz);
+    myLSM.setGyroFullScale(LSM6DSV16X_1000dps);
+
+    // Batch both sensors into the FIFO.
+    myLSM.setAccelFifoBatchSet(LSM6DSV16X_XL_BATCHED_AT_1920Hz);
+    myLSM.setGyroFifoBatchSet(LSM6DSV16X_GY_BATCHED_AT_1920Hz);
+    myLSM.setFifoMode(LSM6DSV16X_STREAM_MODE);
+
+    // The first frame tells the host the full scales and batch rates.
+    framer.begin(Serial, myLSM.getFifoDecoder());
+}
+
+void loop()
+{
+    // Read everything the FIFO holds in one burst.
+    uint16_t count = myLSM.readFifoBatch();
+
+    if (count == 0)
+        return;
+
+    const sfe_lsm_fifo_word_t *words = myLSM.getBurstFifoWords(&count);
+
+    framer.writeWords(words, count);
+}
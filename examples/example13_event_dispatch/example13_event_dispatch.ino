@@ -0,0 +1,132 @@
+/*
+  example13-event-dispatch
+
+  This example reacts to single and double taps through the event
+    dispatcher. Both taps are routed to interrupt one, whose handler only notes
+    that the pin went active. The main loop calls serviceEvents(), which reads
+    the tap sources in one burst and calls the function registered for each
+    event that occurred.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// Interrupt pin
+byte interrupt_pin = 10;
+
+void eventISR()
+{
+    myLSM.eventISR();
+}
+
+void onTap(sfe_lsm_event_t event, const lsm6dsv16x_all_sources_t *source, void *context)
+{
+    if (event == LSM_EVENT_DOUBLE_TAP)
+        Serial.print("Double tap, ");
+    else
+        Serial.print("Single tap, ");
+
+    Serial.println(source->tap_sign ? "downwards" : "upwards");
+}
+
+void setup()
+{
+    pinMode(interrupt_pin, INPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 13 - Event Dispatch");
+
+    Wire.begin();
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_480Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_8g);
+
+    // Single and double taps on the Z axis, see example 6 for the tap settings.
+    myLSM.enableTapInterrupt();
+
+    lsm6dsv16x_tap_detection_t directionEnable;
+    directionEnable.tap_x_en = 0;
+    directionEnable.tap_y_en = 0;
+    directionEnable.tap_z_en = 1;
+    myLSM.setTapDirection(directionEnable);
+
+    lsm6dsv16x_tap_thresholds_t tapThreshold;
+    tapThreshold.x = 0;
+    tapThreshold.y = 0;
+    tapThreshold.z = 2;
+    myLSM.setTapThresholds(tapThreshold);
+
+    lsm6dsv16x_tap_time_windows_t tapWindows;
+    tapWindows.shock = 1;
+    tapWindows.quiet = 1;
+    tapWindows.tap_gap = 7;
+    myLSM.setTapTimeWindows(tapWindows);
+
+    myLSM.setTapMode(LSM6DSV16X_BOTH_SINGLE_DOUBLE);
+
+    // Latch the tap sources: the pin stays high until serviceEvents() reads
+    // them, which also acknowledges them, so a tap is not lost while the loop
+    // is busy.
+    myLSM.setIntLatched(LSM_INT_CLASS_EVENTS);
+
+    // Route both taps to interrupt one.
+    lsm6dsv16x_pin_int_route_t route = {};
+    route.single_tap = 1;
+    route.double_tap = 1;
+    myLSM.setIntRoute(route, LSM_PIN_ONE);
+
+    myLSM.setEventHandler(LSM_EVENT_SINGLE_TAP, onTap);
+    myLSM.setEventHandler(LSM_EVENT_DOUBLE_TAP, onTap);
+
+    attachInterrupt(digitalPinToInterrupt(interrupt_pin), eventISR, RISING);
+
+    Serial.println("Ready.");
+}
+
+void loop()
+{
+    // Reads the sources and calls onTap() when the interrupt has fired.
+    myLSM.serviceEvents();
+}
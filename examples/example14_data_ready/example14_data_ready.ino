@@ -0,0 +1,136 @@
+/*
+  example14-data-ready
+
+  This example reads every accelerometer and gyroscope sample once, on its
+    data ready pulse, without going through the FIFO. The pulse on interrupt
+    one only notes that a sample is ready; the main loop reads it into a
+    ring buffer and a second step takes it out of the ring. Once a second the
+    number of samples read and missed is printed together with the effective
+    sample rate and the jitter of the sample period, both measured with the
+    device timestamp.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// Interrupt pin
+byte interrupt_pin = 10;
+
+// Samples waiting to be processed
+SfeLSMRing<sfe_lsm_drdy_sample_t, 32> samples;
+
+unsigned long lastPrint = 0;
+
+void dataReadyISR()
+{
+    myLSM.dataReadyISR();
+}
+
+void setup()
+{
+    pinMode(interrupt_pin, INPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 14 - Data Ready Acquisition");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_480Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_4g);
+    myLSM.setGyroDataRate(LSM6DSV16X_ODR_AT_480Hz);
+    myLSM.setGyroFullScale(LSM6DSV16X_1000dps);
+
+    attachInterrupt(digitalPinToInterrupt(interrupt_pin), dataReadyISR, RISING);
+
+    // Read both sensors on the accelerometer's data ready pulse.
+    if (!myLSM.beginDataReady(LSM_PIN_ONE, true, true))
+    {
+        Serial.println("Could not start data ready acquisition.");
+        while (1)
+            ;
+    }
+
+    Serial.println("Ready.");
+}
+
+void loop()
+{
+    // Reads the sample when its pulse has arrived.
+    myLSM.serviceDataReady(samples);
+
+    sfe_lsm_drdy_sample_t sample;
+
+    while (samples.pop(&sample))
+    {
+        // A repeat of the previous sample, e.g. after noise on the line.
+        if (sample.stale)
+            continue;
+
+        // A control loop would use the sample here.
+        if (sample.missed > 0)
+        {
+            Serial.print("Missed ");
+            Serial.print(sample.missed);
+            Serial.println(" samples");
+        }
+    }
+
+    if (millis() - lastPrint < 1000)
+        return;
+
+    lastPrint = millis();
+
+    sfe_lsm_drdy_stats_t stats = myLSM.getDataReadyStats();
+
+    Serial.print(stats.samples);
+    Serial.print(" samples, ");
+    Serial.print(stats.missed);
+    Serial.print(" missed, ");
+    Serial.print(stats.rateHz);
+    Serial.print(" Hz, period ");
+    Serial.print(stats.meanPeriodUs);
+    Serial.print(" us, read jitter ");
+    Serial.print(stats.readJitterUs);
+    Serial.println(" us");
+}
@@ -0,0 +1,118 @@
+/*
+  example15-auto-power-down
+
+  This example lets the device power itself down while it lies still. After
+    about eight seconds without motion it drops the accelerometer to 1.875Hz
+    and powers the gyroscope down; the first movement above the wake-up
+    threshold brings both back to 120Hz. The device does this on its own, the
+    board only hears about it: the sleep change is routed to interrupt one,
+    latched until it is read, and serviceEvents() calls onActivity() with the
+    new state.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// Interrupt pin
+byte interrupt_pin = 10;
+
+void eventISR()
+{
+    myLSM.eventISR();
+}
+
+void onActivity(bool active, void *context)
+{
+    (void)context;
+
+    if (active)
+        Serial.println("Moving: accelerometer and gyroscope at 120Hz");
+    else
+        Serial.println("Still: accelerometer at 1.875Hz, gyroscope off");
+}
+
+void setup()
+{
+    pinMode(interrupt_pin, INPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 15 - Auto Power Down");
+
+    Wire.begin();
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_120Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_4g);
+    myLSM.setGyroDataRate(LSM6DSV16X_ODR_AT_120Hz);
+    myLSM.setGyroFullScale(LSM6DSV16X_1000dps);
+
+    // Wake on more than 4 x 7.8125mg = 31.25mg of motion for at least one
+    // sample.
+    lsm6dsv16x_act_thresholds_t thresholds = {};
+    thresholds.inactivity_cfg.wu_inact_ths_w = 0;
+    thresholds.inactivity_cfg.xl_inact_odr = LSM6DSV16X_1Hz875;
+    thresholds.threshold = 4;
+    thresholds.duration = 1;
+    myLSM.setActivityThresholds(thresholds);
+
+    // Go to sleep after 2 x 512 / 120Hz, about 8.5 seconds, without motion.
+    lsm6dsv16x_act_wkup_time_windows_t windows;
+    windows.shock = 1;
+    windows.quiet = 2;
+    myLSM.setActivityTimeWindows(windows);
+
+    myLSM.setActivityHandler(onActivity);
+    myLSM.beginAutoPowerDown(LSM_PIN_ONE, LSM6DSV16X_XL_LOW_POWER_GY_POWER_DOWN, LSM6DSV16X_1Hz875);
+
+    attachInterrupt(digitalPinToInterrupt(interrupt_pin), eventISR, RISING);
+
+    Serial.println("Ready, put the board down to let it sleep.");
+}
+
+void loop()
+{
+    // Reads the sleep change and calls onActivity() when the interrupt has
+    // fired. The change stays latched, a slow loop does not miss it.
+    myLSM.serviceEvents();
+}
@@ -100,13 +100,19 @@ void setup()
 void loop()
 {
 
-    // Check if data is available.
-    if (myLSM.checkQvar())
+    // Check if data is available and read it in the same bus transaction.
+    // This replaces the pair of calls below:
+    // if (myLSM.checkQvar())
+    //     myLSM.getRawQvar(&qvar);
+    if (myLSM.getQvarIfReady(&qvar))
     {
-        myLSM.getRawQvar(&qvar);
         // Serial.print("Qvar: ");
         Serial.println(qvar);
     }
 
+    // To grab a block of samples at the full data rate instead:
+    // int16_t qvarBuffer[64];
+    // uint16_t captured = myLSM.captureQvar(qvarBuffer, 64);
+
     delay(4);
 }
@@ -0,0 +1,158 @@
+/*
+  example7-fifo-burst
+
+  This example compares two ways of draining the FIFO: reading one tagged word
+    per bus transaction, and readFifoBatch() which reads the FIFO level once and
+    then pulls every available word in one burst. Accelerometer and gyroscope
+    are batched at 1.92kHz and then at 7.68kHz, and for each method the example
+    prints the time spent on the bus per word and how many words were drained
+    versus how many the device produced.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// The FIFO holds up to 512 words, enough room to drain it in a single call.
+#define FIFO_WORDS 512
+sfe_lsm_fifo_word_t fifoWords[FIFO_WORDS];
+
+// How long each method runs for.
+const uint32_t benchmarkMs = 2000;
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 7 - FIFO Burst Drain");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+
+    // Accelerometer and Gyroscope registers will not be updated
+    // until read.
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelFullScale(LSM6DSV16X_16g);
+    myLSM.setGyroFullScale(LSM6DSV16X_2000dps);
+
+    Serial.println("Ready.");
+}
+
+// Reads the FIFO one word per transaction, the same bus traffic as calling
+// lsm6dsv16x_fifo_out_raw_get() in a loop.
+uint16_t drainPerWord()
+{
+    lsm6dsv16x_fifo_status_t status;
+
+    if (!myLSM.getFifoStatus(&status))
+        return 0;
+
+    for (uint16_t i = 0; i < status.fifo_level; i++)
+        myLSM.readRegisterRegion(LSM6DSV16X_FIFO_DATA_OUT_TAG, (uint8_t *)&fifoWords[0], sizeof(sfe_lsm_fifo_word_t));
+
+    return status.fifo_level;
+}
+
+uint16_t drainBurst()
+{
+    return myLSM.readFifoBatch(fifoWords, FIFO_WORDS);
+}
+
+void runBenchmark(const char *name, uint16_t (*drain)(), float wordsPerSecond)
+{
+    uint32_t words = 0;
+    uint32_t busMicros = 0;
+
+    // Start from an empty FIFO.
+    myLSM.setFifoMode(LSM6DSV16X_BYPASS_MODE);
+    myLSM.setFifoMode(LSM6DSV16X_STREAM_MODE);
+
+    uint32_t start = millis();
+
+    while (millis() - start < benchmarkMs)
+    {
+        uint32_t t0 = micros();
+        uint16_t count = drain();
+        uint32_t t1 = micros();
+
+        if (count > 0)
+        {
+            words += count;
+            busMicros += t1 - t0;
+        }
+    }
+
+    float produced = wordsPerSecond * benchmarkMs / 1000.0;
+
+    Serial.print("  ");
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(words);
+    Serial.print(" words, ");
+    Serial.print(words ? (float)busMicros / words : 0.0);
+    Serial.print(" us/word, drained ");
+    Serial.print(100.0 * words / produced);
+    Serial.println("% of produced");
+}
+
+void benchmarkRate(lsm6dsv16x_data_rate_t odr, lsm6dsv16x_fifo_xl_batch_t xlBatch,
+                   lsm6dsv16x_fifo_gy_batch_t gyBatch, float hz)
+{
+    myLSM.setAccelDataRate(odr);
+    myLSM.setGyroDataRate(odr);
+    myLSM.setAccelFifoBatchSet(xlBatch);
+    myLSM.setGyroFifoBatchSet(gyBatch);
+
+    Serial.print(hz);
+    Serial.println("Hz accelerometer + gyroscope:");
+
+    runBenchmark("per word", drainPerWord, 2 * hz);
+    runBenchmark("burst   ", drainBurst, 2 * hz);
+}
+
+void loop()
+{
+    benchmarkRate(LSM6DSV16X_ODR_AT_1920Hz, LSM6DSV16X_XL_BATCHED_AT_1920Hz, LSM6DSV16X_GY_BATCHED_AT_1920Hz, 1920);
+    benchmarkRate(LSM6DSV16X_ODR_AT_7680Hz, LSM6DSV16X_XL_BATCHED_AT_7680Hz, LSM6DSV16X_GY_BATCHED_AT_7680Hz, 7680);
+
+    Serial.println();
+    delay(1000);
+}
@@ -0,0 +1,151 @@
+/*
+  example8-fifo-stream
+
+  This example streams accelerometer and gyroscope data through the FIFO at
+    960Hz. The FIFO watermark is routed to interrupt one, the interrupt handler
+    only notes that the watermark was reached and the main loop drains the FIFO
+    into one of two buffers while the other one is being processed. Every
+    buffer is decoded and the average of its accelerometer samples is printed.
+    The watermark adapts to how quickly the main loop gets to the drain.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+// Interrupt pin
+byte interrupt_pin = 10;
+
+// Two buffers, one is filled from the FIFO while the other is processed.
+#define WATERMARK 64
+#define BUFFER_WORDS 128
+sfe_lsm_fifo_word_t bufferA[BUFFER_WORDS];
+sfe_lsm_fifo_word_t bufferB[BUFFER_WORDS];
+
+// Running sum of the accelerometer samples of one buffer.
+sfe_lsm_data_t accelSum;
+uint16_t accelSamples = 0;
+
+void watermarkISR()
+{
+    myLSM.fifoWatermarkISR();
+}
+
+void onAccel(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    accelSum.xData += sample->vector.xData;
+    accelSum.yData += sample->vector.yData;
+    accelSum.zData += sample->vector.zData;
+    accelSamples++;
+}
+
+void setup()
+{
+    pinMode(interrupt_pin, INPUT);
+
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 8 - FIFO Streaming");
+
+    Wire.begin();
+    Wire.setClock(400000);
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.enableBlockDataUpdate();
+
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_960Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_4g);
+    myLSM.setGyroDataRate(LSM6DSV16X_ODR_AT_960Hz);
+    myLSM.setGyroFullScale(LSM6DSV16X_1000dps);
+
+    // Batch both sensors into the FIFO.
+    myLSM.setAccelFifoBatchSet(LSM6DSV16X_XL_BATCHED_AT_960Hz);
+    myLSM.setGyroFifoBatchSet(LSM6DSV16X_GY_BATCHED_AT_960Hz);
+
+    myLSM.setFifoHandler(LSM_FIFO_ACCEL, onAccel);
+
+    attachInterrupt(digitalPinToInterrupt(interrupt_pin), watermarkISR, RISING);
+
+    if (!myLSM.beginFifoStream(bufferA, bufferB, BUFFER_WORDS, WATERMARK, LSM_PIN_ONE))
+    {
+        Serial.println("Could not start FIFO streaming.");
+        while (1)
+            ;
+    }
+
+    // Optional: let the watermark follow the main loop's drain latency,
+    // between 16 and 96 words, keeping the FIFO level under 112 words.
+    myLSM.enableAdaptiveWatermark(16, 96, 112);
+
+    Serial.println("Ready.");
+}
+
+void loop()
+{
+    // Drains the FIFO when the watermark interrupt has fired.
+    myLSM.serviceFifoStream();
+
+    uint16_t count;
+    const sfe_lsm_fifo_word_t *words = myLSM.getFifoStreamBuffer(&count);
+
+    if (words == nullptr)
+        return;
+
+    accelSum.xData = accelSum.yData = accelSum.zData = 0;
+    accelSamples = 0;
+
+    myLSM.getFifoDecoder().decode(words, count);
+
+    // Done with the buffer, it can be filled again.
+    myLSM.releaseFifoStreamBuffer(words);
+
+    if (accelSamples == 0)
+        return;
+
+    Serial.print(count);
+    Serial.print(" words, watermark ");
+    Serial.print(myLSM.getFifoWatermark());
+    Serial.print(", accel average X: ");
+    Serial.print(accelSum.xData / accelSamples);
+    Serial.print(" Y: ");
+    Serial.print(accelSum.yData / accelSamples);
+    Serial.print(" Z: ");
+    Serial.println(accelSum.zData / accelSamples);
+}
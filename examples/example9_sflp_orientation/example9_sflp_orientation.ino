@@ -0,0 +1,107 @@
+/*
+  example9-sflp-orientation
+
+  This example turns on the sensor fusion low power (SFLP) block, which
+    computes the device's orientation on the sensor itself. The game rotation
+    vector and the gravity vector are batched into the FIFO, decoded by the
+    library and printed as a quaternion and a vector in milli-g's.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+
+    Products:
+
+    SparkFun 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21325
+
+    SparkFun Micro 6DoF LSM6DSV16X (Qwiic):
+        https://www.sparkfun.com/products/21336
+
+  Repository:
+        https://github.com/sparkfun/SparkFun_LSM6DSV16X_Arduino_Library
+*/
+
+#include "SparkFun_LSM6DSV16X.h"
+#include <Wire.h>
+
+SparkFun_LSM6DSV16X myLSM;
+
+void onGameRotation(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    Serial.print("Quaternion X: ");
+    Serial.print(sample->quaternion[0], 4);
+    Serial.print(" Y: ");
+    Serial.print(sample->quaternion[1], 4);
+    Serial.print(" Z: ");
+    Serial.print(sample->quaternion[2], 4);
+    Serial.print(" W: ");
+    Serial.println(sample->quaternion[3], 4);
+}
+
+void onGravity(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    Serial.print("Gravity X: ");
+    Serial.print(sample->vector.xData);
+    Serial.print(" Y: ");
+    Serial.print(sample->vector.yData);
+    Serial.print(" Z: ");
+    Serial.println(sample->vector.zData);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    while (!Serial)
+    {
+    }
+
+    Serial.println("LSM6DSV16X Example 9 - SFLP Orientation");
+
+    Wire.begin();
+
+    if (!myLSM.begin())
+    {
+        Serial.println("Did not begin, check your wiring and/or I2C address!");
+        while (1)
+            ;
+    }
+
+    // Reset the device to default settings. This is helpful if you're doing multiple
+    // uploads testing different settings.
+    myLSM.deviceReset();
+
+    // Wait for it to finish reseting
+    while (!myLSM.getDeviceReset())
+    {
+        delay(1);
+    }
+
+    Serial.println("Board has been Reset.");
+    Serial.println("Applying settings.");
+
+    myLSM.enableBlockDataUpdate();
+
+    // SFLP runs off the accelerometer and gyroscope.
+    myLSM.setAccelDataRate(LSM6DSV16X_ODR_AT_120Hz);
+    myLSM.setAccelFullScale(LSM6DSV16X_4g);
+    myLSM.setGyroDataRate(LSM6DSV16X_ODR_AT_120Hz);
+    myLSM.setGyroFullScale(LSM6DSV16X_2000dps);
+
+    myLSM.enableSFLP(LSM6DSV16X_SFLP_30Hz);
+    myLSM.setSFLPFifoBatch(true, true, false);
+
+    myLSM.setFifoHandler(LSM_FIFO_GAME_ROTATION, onGameRotation);
+    myLSM.setFifoHandler(LSM_FIFO_GRAVITY, onGravity);
+
+    myLSM.setFifoMode(LSM6DSV16X_STREAM_MODE);
+
+    Serial.println("Ready.");
+}
+
+void loop()
+{
+    // Decodes everything in the FIFO and calls the handlers above.
+    myLSM.processFifo();
+
+    delay(100);
+}
@@ -0,0 +1,512 @@
+/*
+  fifo_compression_test
+
+  Host check of the FIFO decompression in SfeLSMFifoDecoder. A model of the
+    device's compressor turns known accelerometer and gyroscope sequences
+    into XL/GY_NC, NC_T_1, NC_T_2, 2XC and 3XC words with running tag
+    counters; the decoder has to give back every sample bit for bit, in
+    order, with the right delay and without reporting dropped samples. The
+    sequences cover each word format, the tag counter wrapping from 3 to 0
+    and 16-bit values wrapping through a delta.
+
+  The model shares its reading of the word layout with the decoder, so a
+    fixed stream of words checks that reading on its own. Its expected
+    samples are worked out by hand from the unpacking in ST's st_fifo
+    library: 2XC words hold six signed bytes, x/y/z at t-2 then at t-1;
+    3XC words hold three little endian 16-bit words for t-2, t-1 and t,
+    each with x/y/z as signed 5-bit fields from bit 0.
+
+  Build on Linux or macOS from this directory:
+
+    gcc -O2 -c ../../src/st_src/lsm6dsv16x_reg.c -o lsm6dsv16x_reg.o
+    g++ -O2 -I../../src fifo_compression_test.cpp ../../src/sfe_lsm_fifo.cpp lsm6dsv16x_reg.o \
+        -o fifo_compression_test
+
+  Usage:
+
+    fifo_compression_test
+
+  Prints one line per case and exits with 1 if any case failed.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "sfe_lsm_fifo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kMaxSamples 4096
+
+// FIFO tags of the accelerometer, the gyroscope ones follow at +8 except NC.
+enum
+{
+    kTagGyNc = 0x01,
+    kTagXlNc = 0x02,
+    kTagXlNcT2 = 0x06,
+    kTagXlNcT1 = 0x07,
+    kTagXl2xc = 0x08,
+    kTagXl3xc = 0x09,
+    kTagGyOffset = 0x04
+};
+
+// Word formats the compressor model can pick.
+typedef enum
+{
+    kFormatNc = 0x00,
+    kFormatNcT1,
+    kFormatNcT2,
+    kFormat2xc,
+    kFormat3xc,
+    kFormatNum
+} compressFormat_t;
+
+static const char *kFormatNames[kFormatNum] = {"NC", "NC_T_1", "NC_T_2", "2XC", "3XC"};
+
+struct sample_t
+{
+    int16_t axis[3];
+};
+
+struct encoder_t
+{
+    bool gyro;
+    sfe_lsm_fifo_word_t words[kMaxSamples];
+    uint16_t wordCount;
+    uint8_t expectedDelay[kMaxSamples]; // Delay of each sample, in sample order
+    uint32_t formatCount[kFormatNum];
+};
+
+struct decoded_t
+{
+    sample_t samples[kMaxSamples];
+    uint8_t delay[kMaxSamples];
+    uint16_t count;
+};
+
+static int16_t deltaOf(int16_t value, int16_t previous)
+{
+    return (int16_t)(uint16_t)((uint16_t)value - (uint16_t)previous);
+}
+
+// True if every axis of the samples from first on differs from the one
+// before by no more than the limit, chaining from the reference.
+static bool deltasFit(const sample_t *samples, uint16_t first, uint8_t count, const sample_t &reference,
+                      int16_t limit)
+{
+    sample_t previous = reference;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            int16_t delta = deltaOf(samples[first + i].axis[axis], previous.axis[axis]);
+
+            if (delta < -limit - 1 || delta > limit)
+                return false;
+        }
+
+        previous = samples[first + i];
+    }
+
+    return true;
+}
+
+static void emitWord(encoder_t &encoder, uint8_t tag, uint32_t step, const uint8_t data[6])
+{
+    sfe_lsm_fifo_word_t &word = encoder.words[encoder.wordCount++];
+
+    if (encoder.gyro)
+        tag = (tag == kTagXlNc) ? (uint8_t)kTagGyNc : (uint8_t)(tag + kTagGyOffset);
+
+    word.tag = (uint8_t)((tag << 3) | ((step & 0x03) << 1));
+    memcpy(word.data, data, 6);
+}
+
+static void packRaw(const sample_t &sample, uint8_t data[6])
+{
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        data[2 * axis] = (uint8_t)sample.axis[axis];
+        data[2 * axis + 1] = (uint8_t)((uint16_t)sample.axis[axis] >> 8);
+    }
+}
+
+// Model of the compressor: 3XC while three samples fit 5-bit deltas, 2XC
+// while two fit 8-bit deltas, otherwise an uncompressed word. The
+// uncompressed format rotates through NC, NC_T_1 and NC_T_2 as far as the
+// tag counter allows, which only ever moves forward by up to three steps.
+// A word's tag counter is the step of its newest batch period t; the
+// samples it carries belong to t minus their delay.
+static void encode(encoder_t &encoder, const sample_t *samples, uint16_t count)
+{
+    sample_t reference = {};
+    bool referenceValid = false;
+    uint32_t lastStep = 0;
+    uint8_t rotate = 0;
+    uint16_t next = 0;
+    uint8_t data[6];
+
+    encoder.wordCount = 0;
+    memset(encoder.formatCount, 0, sizeof(encoder.formatCount));
+
+    while (next < count)
+    {
+        compressFormat_t format;
+
+        if (referenceValid && next + 3 <= count && deltasFit(samples, next, 3, reference, 15))
+            format = kFormat3xc;
+        else if (referenceValid && next + 2 <= count && deltasFit(samples, next, 2, reference, 127))
+            format = kFormat2xc;
+        else
+        {
+            format = (compressFormat_t)(kFormatNc + rotate++ % 3);
+
+            // NC puts the sample at its own step, which may lie behind the
+            // previous word's step.
+            if (format == kFormatNc && next < lastStep)
+                format = kFormatNcT1;
+            if (format == kFormatNcT1 && (uint32_t)next + 1 < lastStep)
+                format = kFormatNcT2;
+        }
+
+        uint32_t step;
+
+        switch (format)
+        {
+        case kFormat3xc:
+            step = next + 2;
+            for (uint8_t i = 0; i < 3; i++)
+            {
+                uint16_t packed = 0;
+
+                for (uint8_t axis = 0; axis < 3; axis++)
+                    packed |= (uint16_t)(deltaOf(samples[next + i].axis[axis], reference.axis[axis]) & 0x1F)
+                              << (5 * axis);
+
+                data[2 * i] = (uint8_t)packed;
+                data[2 * i + 1] = (uint8_t)(packed >> 8);
+                reference = samples[next + i];
+                encoder.expectedDelay[next + i] = 2 - i;
+            }
+            emitWord(encoder, kTagXl3xc, step, data);
+            next += 3;
+            break;
+
+        case kFormat2xc:
+            step = next + 2;
+            for (uint8_t i = 0; i < 2; i++)
+            {
+                for (uint8_t axis = 0; axis < 3; axis++)
+                    data[3 * i + axis] = (uint8_t)deltaOf(samples[next + i].axis[axis], reference.axis[axis]);
+
+                reference = samples[next + i];
+                encoder.expectedDelay[next + i] = 2 - i;
+            }
+            emitWord(encoder, kTagXl2xc, step, data);
+            next += 2;
+            break;
+
+        default: {
+            uint8_t delay = (format == kFormatNcT2) ? 2 : (format == kFormatNcT1) ? 1 : 0;
+            uint8_t tag = (format == kFormatNcT2) ? kTagXlNcT2 : (format == kFormatNcT1) ? kTagXlNcT1 : kTagXlNc;
+
+            step = next + delay;
+            packRaw(samples[next], data);
+            emitWord(encoder, tag, step, data);
+            encoder.expectedDelay[next] = delay;
+            reference = samples[next];
+            referenceValid = true;
+            next++;
+            break;
+        }
+        }
+
+        if (step < lastStep || step - lastStep > 3)
+        {
+            fprintf(stderr, "encoder model produced a step of %ld\n", (long)step - (long)lastStep);
+            exit(2);
+        }
+
+        lastStep = step;
+        encoder.formatCount[format]++;
+    }
+}
+
+static void onSample(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    decoded_t *decoded = (decoded_t *)context;
+
+    if (decoded->count == kMaxSamples)
+        return;
+
+    memcpy(decoded->samples[decoded->count].axis, sample->raw, sizeof(sample->raw));
+    decoded->delay[decoded->count] = sample->delay;
+    decoded->count++;
+}
+
+// Encodes the samples, decodes the words in chunks of the given size and
+// compares. Returns true if the round trip is exact.
+static bool roundTrip(const char *name, bool gyro, const sample_t *samples, uint16_t count, uint16_t chunk,
+                      const bool *required)
+{
+    static encoder_t encoder;
+    static decoded_t decoded;
+    SfeLSMFifoDecoder decoder;
+    bool success = true;
+
+    encoder.gyro = gyro;
+    decoded.count = 0;
+
+    encode(encoder, samples, count);
+
+    decoder.setHandler(gyro ? LSM_FIFO_GYRO : LSM_FIFO_ACCEL, onSample, &decoded);
+    decoder.setBatchRates(gyro ? 0.0f : 120.0f, gyro ? 120.0f : 0.0f);
+
+    for (uint16_t first = 0; first < encoder.wordCount; first += chunk)
+    {
+        uint16_t words = (encoder.wordCount - first < chunk) ? encoder.wordCount - first : chunk;
+        decoder.decode(&encoder.words[first], words);
+    }
+
+    if (decoded.count != count)
+    {
+        printf("FAIL %s: %u samples decoded, %u encoded\n", name, decoded.count, count);
+        return false;
+    }
+
+    for (uint16_t i = 0; i < count && success; i++)
+    {
+        if (memcmp(decoded.samples[i].axis, samples[i].axis, sizeof(samples[i].axis)) != 0)
+        {
+            printf("FAIL %s: sample %u is %d,%d,%d, expected %d,%d,%d\n", name, i, decoded.samples[i].axis[0],
+                   decoded.samples[i].axis[1], decoded.samples[i].axis[2], samples[i].axis[0], samples[i].axis[1],
+                   samples[i].axis[2]);
+            success = false;
+        }
+        else if (decoded.delay[i] != encoder.expectedDelay[i])
+        {
+            printf("FAIL %s: sample %u has delay %u, expected %u\n", name, i, decoded.delay[i],
+                   encoder.expectedDelay[i]);
+            success = false;
+        }
+    }
+
+    if (success && decoder.getDroppedSamples() != 0)
+    {
+        printf("FAIL %s: %u samples reported dropped\n", name, decoder.getDroppedSamples());
+        success = false;
+    }
+
+    for (uint8_t format = 0; format < kFormatNum && success; format++)
+    {
+        if (required[format] && encoder.formatCount[format] == 0)
+        {
+            printf("FAIL %s: no %s words were produced\n", name, kFormatNames[format]);
+            success = false;
+        }
+    }
+
+    if (success)
+        printf("ok   %s: %u samples in %u words (NC %u, NC_T_1 %u, NC_T_2 %u, 2XC %u, 3XC %u)\n", name, count,
+               encoder.wordCount, encoder.formatCount[kFormatNc], encoder.formatCount[kFormatNcT1],
+               encoder.formatCount[kFormatNcT2], encoder.formatCount[kFormat2xc], encoder.formatCount[kFormat3xc]);
+
+    return success;
+}
+
+// Small steps, 3XC throughout after the first word.
+static uint16_t makeSlow(sample_t *samples)
+{
+    for (uint16_t i = 0; i < 300; i++)
+    {
+        samples[i].axis[0] = (int16_t)(1000 + (i % 31) - 15);
+        samples[i].axis[1] = (int16_t)(-2000 + i);
+        samples[i].axis[2] = (int16_t)(16384 - 2 * i);
+    }
+    return 300;
+}
+
+// Medium steps, 2XC.
+static uint16_t makeMedium(sample_t *samples)
+{
+    for (uint16_t i = 0; i < 300; i++)
+    {
+        samples[i].axis[0] = (int16_t)(100 * (int16_t)(i % 3));
+        samples[i].axis[1] = (int16_t)(-50 * (int16_t)(i % 5));
+        samples[i].axis[2] = (int16_t)(8000 + 127 * (int16_t)(i & 1));
+    }
+    return 300;
+}
+
+// Large jumps only, every uncompressed format.
+static uint16_t makeJumps(sample_t *samples)
+{
+    for (uint16_t i = 0; i < 300; i++)
+    {
+        samples[i].axis[0] = (int16_t)((i & 1) ? 20000 : -20000);
+        samples[i].axis[1] = (int16_t)(i * 211);
+        samples[i].axis[2] = (int16_t)(-(int16_t)i * 97);
+    }
+    return 300;
+}
+
+// Values that wrap through +32767 / -32768 within a delta.
+static uint16_t makeWrap(sample_t *samples)
+{
+    for (uint16_t i = 0; i < 200; i++)
+    {
+        samples[i].axis[0] = (int16_t)(uint16_t)(32700 + 7 * i);
+        samples[i].axis[1] = (int16_t)(uint16_t)(32768 - 3 * i);
+        samples[i].axis[2] = (int16_t)(uint16_t)(32760 + 90 * (i & 1));
+    }
+    return 200;
+}
+
+// A random walk with bursts, a mix of all formats.
+static uint16_t makeMixed(sample_t *samples)
+{
+    uint32_t seed = 12345;
+    int16_t value[3] = {0, 0, 0};
+
+    for (uint16_t i = 0; i < kMaxSamples; i++)
+    {
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            uint32_t r = (seed >> 16) & 0x7FFF;
+            int16_t step = (r % 16 == 0) ? (int16_t)(r % 4001) - 2000 : (r % 4 == 0) ? (int16_t)(r % 201) - 100
+                                                                                      : (int16_t)(r % 21) - 10;
+            value[axis] = (int16_t)(uint16_t)((uint16_t)value[axis] + (uint16_t)step);
+            samples[i].axis[axis] = value[axis];
+        }
+    }
+    return kMaxSamples;
+}
+
+// Hand-built FIFO words: tag byte (tag << 3 | counter << 1) and payload.
+// Sample n belongs to batch period n.
+static const sfe_lsm_fifo_word_t kFixedWords[] = {
+    // XL_NC, counter 0: 1000, -2000, 16384
+    {(0x02 << 3) | (0 << 1), {0xE8, 0x03, 0x30, 0xF8, 0x00, 0x40}},
+    // XL_2XC, counter 3: +5, -3, +127 then -128, +1, 0
+    {(0x08 << 3) | (3 << 1), {0x05, 0xFD, 0x7F, 0x80, 0x01, 0x00}},
+    // XL_3XC, counter 5 & 3: 15, -16, -1 = 0x7E0F; 0, 1, -2 = 0x7820; -16, 15, 3 = 0x0DF0
+    {(0x09 << 3) | (1 << 1), {0x0F, 0x7E, 0x20, 0x78, 0xF0, 0x0D}},
+    // XL_NC_T_1, counter 7 & 3: -32768, 32767, 0
+    {(0x07 << 3) | (3 << 1), {0x00, 0x80, 0xFF, 0x7F, 0x00, 0x00}},
+    // XL_2XC, counter 9 & 3: -1, +1, -128 then +1, -1, +127, both wrapping
+    {(0x08 << 3) | (1 << 1), {0xFF, 0x01, 0x80, 0x01, 0xFF, 0x7F}},
+    // XL_NC_T_2, counter 11 & 3: 12345, -12345, 1
+    {(0x06 << 3) | (3 << 1), {0x39, 0x30, 0xC7, 0xCF, 0x01, 0x00}},
+};
+
+struct fixedSample_t
+{
+    int16_t axis[3];
+    uint8_t delay;
+};
+
+static const fixedSample_t kFixedSamples[] = {
+    {{1000, -2000, 16384}, 0},  {{1005, -2003, 16511}, 2},   {{877, -2002, 16511}, 1},
+    {{892, -2018, 16510}, 2},   {{892, -2017, 16508}, 1},    {{876, -2002, 16511}, 0},
+    {{-32768, 32767, 0}, 1},    {{32767, -32768, -128}, 2},  {{-32768, 32767, -1}, 1},
+    {{12345, -12345, 1}, 2},
+};
+
+// Decodes the fixed words, as accelerometer or with the gyroscope tags, and
+// compares with the samples worked out by hand.
+static bool fixedVectors(const char *name, bool gyro)
+{
+    const uint16_t numWords = sizeof(kFixedWords) / sizeof(kFixedWords[0]);
+    const uint16_t numSamples = sizeof(kFixedSamples) / sizeof(kFixedSamples[0]);
+    static decoded_t decoded;
+    sfe_lsm_fifo_word_t words[numWords];
+    SfeLSMFifoDecoder decoder;
+
+    memcpy(words, kFixedWords, sizeof(words));
+
+    for (uint16_t i = 0; gyro && i < numWords; i++)
+    {
+        uint8_t tag = words[i].tag >> 3;
+
+        tag = (tag == kTagXlNc) ? (uint8_t)kTagGyNc : (uint8_t)(tag + kTagGyOffset);
+        words[i].tag = (uint8_t)((tag << 3) | (words[i].tag & 0x07));
+    }
+
+    decoded.count = 0;
+    decoder.setHandler(gyro ? LSM_FIFO_GYRO : LSM_FIFO_ACCEL, onSample, &decoded);
+    decoder.setBatchRates(gyro ? 0.0f : 120.0f, gyro ? 120.0f : 0.0f);
+    decoder.decode(words, numWords);
+
+    if (decoded.count != numSamples)
+    {
+        printf("FAIL %s: %u samples decoded, expected %u\n", name, decoded.count, numSamples);
+        return false;
+    }
+
+    for (uint16_t i = 0; i < numSamples; i++)
+    {
+        const fixedSample_t &expected = kFixedSamples[i];
+
+        if (memcmp(decoded.samples[i].axis, expected.axis, sizeof(expected.axis)) != 0 ||
+            decoded.delay[i] != expected.delay)
+        {
+            printf("FAIL %s: sample %u is %d,%d,%d delay %u, expected %d,%d,%d delay %u\n", name, i,
+                   decoded.samples[i].axis[0], decoded.samples[i].axis[1], decoded.samples[i].axis[2],
+                   decoded.delay[i], expected.axis[0], expected.axis[1], expected.axis[2], expected.delay);
+            return false;
+        }
+    }
+
+    if (decoder.getDroppedSamples() != 0)
+    {
+        printf("FAIL %s: %u samples reported dropped\n", name, decoder.getDroppedSamples());
+        return false;
+    }
+
+    printf("ok   %s: %u samples in %u words\n", name, numSamples, numWords);
+
+    return true;
+}
+
+int main()
+{
+    static sample_t samples[kMaxSamples];
+    const bool none[kFormatNum] = {false, false, false, false, false};
+    const bool all[kFormatNum] = {true, true, true, true, true};
+    const bool only3xc[kFormatNum] = {false, false, false, false, true};
+    const bool only2xc[kFormatNum] = {false, false, false, true, false};
+    const bool uncompressed[kFormatNum] = {true, true, true, false, false};
+    int failures = 0;
+    uint16_t count;
+
+    failures += !fixedVectors("accel fixed words", false);
+    failures += !fixedVectors("gyro fixed words", true);
+
+    count = makeSlow(samples);
+    failures += !roundTrip("accel 3XC", false, samples, count, 0xFFFF, only3xc);
+    failures += !roundTrip("gyro 3XC", true, samples, count, 7, only3xc);
+
+    count = makeMedium(samples);
+    failures += !roundTrip("accel 2XC", false, samples, count, 0xFFFF, only2xc);
+    failures += !roundTrip("gyro 2XC", true, samples, count, 5, only2xc);
+
+    count = makeJumps(samples);
+    failures += !roundTrip("accel NC, NC_T_1, NC_T_2", false, samples, count, 0xFFFF, uncompressed);
+    failures += !roundTrip("gyro NC, NC_T_1, NC_T_2", true, samples, count, 1, uncompressed);
+
+    count = makeWrap(samples);
+    failures += !roundTrip("accel 16-bit wrap", false, samples, count, 0xFFFF, none);
+    failures += !roundTrip("gyro 16-bit wrap", true, samples, count, 3, none);
+
+    count = makeMixed(samples);
+    failures += !roundTrip("accel mixed", false, samples, count, 0xFFFF, all);
+    failures += !roundTrip("gyro mixed", true, samples, count, 64, all);
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+/*
+  fifo_config_change_test
+
+  Host check of how SfeLSMFifoDecoder follows settings changed while the
+    FIFO is batching with CFG_CHANGE words. The driver passes its settings
+    on after every full scale, data rate or timing change, many of which
+    leave them as they were; only real changes may wait for a CFG_CHANGE
+    word, or the queue runs ahead of the words in the FIFO and applies the
+    wrong settings from then on. The words still in the FIFO from before a
+    full scale or rate change have to be converted with the old settings,
+    the words after its CFG_CHANGE word with the new ones.
+
+  Build on Linux or macOS from this directory:
+
+    gcc -O2 -c ../../src/st_src/lsm6dsv16x_reg.c -o lsm6dsv16x_reg.o
+    g++ -O2 -I../../src fifo_config_change_test.cpp ../../src/sfe_lsm_fifo.cpp lsm6dsv16x_reg.o \
+        -o fifo_config_change_test
+
+  Usage:
+
+    fifo_config_change_test
+
+  Prints one line per case and exits with 1 if any case failed.
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "sfe_lsm_fifo.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define kMaxWords 64
+#define kRawX 1000
+
+enum
+{
+    kTagGyNc = 0x01,
+    kTagXlNc = 0x02,
+    kTagCfgChange = 0x05
+};
+
+struct fifo_t
+{
+    sfe_lsm_fifo_word_t words[kMaxWords];
+    uint16_t count;
+    uint8_t step;
+};
+
+struct decoded_t
+{
+    float accelX[kMaxWords];
+    uint16_t count;
+};
+
+static void addWord(fifo_t &fifo, uint8_t tag)
+{
+    sfe_lsm_fifo_word_t &word = fifo.words[fifo.count++];
+
+    memset(&word, 0, sizeof(word));
+    word.tag = (uint8_t)((tag << 3) | ((fifo.step & 0x03) << 1));
+    word.data[0] = kRawX & 0xFF;
+    word.data[1] = kRawX >> 8;
+}
+
+// Adds the words of the given number of steps, the accelerometer is batched
+// every accelPeriod steps and the gyroscope every step.
+static void addSteps(fifo_t &fifo, uint8_t steps, uint8_t accelPeriod)
+{
+    for (uint8_t i = 0; i < steps; i++, fifo.step++)
+    {
+        if (fifo.step % accelPeriod == 0)
+            addWord(fifo, kTagXlNc);
+        addWord(fifo, kTagGyNc);
+    }
+}
+
+static void onAccel(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    decoded_t *decoded = (decoded_t *)context;
+
+    decoded->accelX[decoded->count++] = sample->vector.xData;
+}
+
+static void onGyro(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    (void)sample;
+    (void)context;
+}
+
+static sfe_lsm_fifo_config_t makeConfig(lsm6dsv16x_xl_full_scale_t accelScale, float accelHz)
+{
+    sfe_lsm_fifo_config_t config;
+
+    config.accelScale = accelScale;
+    config.gyroScale = LSM6DSV16X_250dps;
+    config.accelBatchHz = accelHz;
+    config.gyroBatchHz = 240.0f;
+
+    return config;
+}
+
+// One run of words between CFG_CHANGE words.
+struct segment_t
+{
+    uint8_t steps;
+    uint8_t accelPeriod; // Steps per accelerometer sample
+    float mg;            // Expected accelerometer x value
+};
+
+// Decodes the segments, a CFG_CHANGE word between each, and checks every
+// accelerometer sample and the settings left in the decoder.
+static bool check(const char *name, SfeLSMFifoDecoder &decoder, const segment_t *segments, uint8_t numSegments,
+                  lsm6dsv16x_xl_full_scale_t scale, float accelHz)
+{
+    static fifo_t fifo;
+    static decoded_t decoded;
+    float expected[kMaxWords];
+    uint16_t numExpected = 0;
+    bool success = true;
+
+    fifo.count = 0;
+    fifo.step = 0;
+    decoded.count = 0;
+
+    for (uint8_t i = 0; i < numSegments; i++)
+    {
+        if (i > 0)
+            addWord(fifo, kTagCfgChange);
+
+        uint16_t first = fifo.count;
+        addSteps(fifo, segments[i].steps, segments[i].accelPeriod);
+        for (uint16_t word = first; word < fifo.count; word++)
+            if ((fifo.words[word].tag >> 3) == kTagXlNc)
+                expected[numExpected++] = segments[i].mg;
+    }
+
+    decoder.setHandler(LSM_FIFO_ACCEL, onAccel, &decoded);
+    decoder.setHandler(LSM_FIFO_GYRO, onGyro);
+
+    if (decoder.getPendingConfigs() != numSegments - 1)
+    {
+        printf("FAIL %s: %u configs queued for %u CFG_CHANGE words\n", name, decoder.getPendingConfigs(),
+               numSegments - 1);
+        success = false;
+    }
+
+    decoder.decode(fifo.words, fifo.count);
+
+    sfe_lsm_fifo_config_t config = decoder.getConfig();
+
+    if (decoder.getPendingConfigs() != 0 || config.accelBatchHz != accelHz || config.accelScale != scale)
+    {
+        printf("FAIL %s: accelerometer at %.0f Hz, full scale %u after the last CFG_CHANGE word, %u configs left\n",
+               name, config.accelBatchHz, config.accelScale, decoder.getPendingConfigs());
+        success = false;
+    }
+
+    if (decoder.getDroppedSamples() != 0)
+    {
+        printf("FAIL %s: %u samples reported dropped\n", name, decoder.getDroppedSamples());
+        success = false;
+    }
+
+    if (decoded.count != numExpected)
+    {
+        printf("FAIL %s: %u accelerometer samples decoded, %u in the FIFO\n", name, decoded.count, numExpected);
+        success = false;
+    }
+
+    for (uint16_t i = 0; i < decoded.count && success; i++)
+    {
+        if (decoded.accelX[i] != expected[i])
+        {
+            printf("FAIL %s: sample %u is %.3f mg, expected %.3f mg\n", name, i, decoded.accelX[i], expected[i]);
+            success = false;
+        }
+    }
+
+    if (success)
+        printf("ok   %s\n", name);
+
+    return success;
+}
+
+int main()
+{
+    int failures = 0;
+
+    // Settings passed on again, e.g. by enableTimestamp(), queue nothing, only
+    // the rate change that follows waits for its word.
+    {
+        SfeLSMFifoDecoder decoder;
+        const segment_t segments[] = {{6, 1, kRawX * 0.061f}, {12, 2, kRawX * 0.061f}};
+
+        decoder.setConfig(makeConfig(LSM6DSV16X_2g, 240.0f));
+        for (uint8_t i = 0; i < 5; i++)
+            decoder.queueConfig(makeConfig(LSM6DSV16X_2g, 240.0f));
+        decoder.queueConfig(makeConfig(LSM6DSV16X_2g, 120.0f));
+
+        failures += !check("repeated settings", decoder, segments, 2, LSM6DSV16X_2g, 120.0f);
+    }
+
+    // Auto-ranging: the words before the CFG_CHANGE word keep the old full
+    // scale, the words after it use the new one.
+    {
+        SfeLSMFifoDecoder decoder;
+        const segment_t segments[] = {{8, 1, kRawX * 0.061f}, {8, 1, kRawX * 0.122f}};
+
+        decoder.setConfig(makeConfig(LSM6DSV16X_2g, 240.0f));
+        decoder.queueConfig(makeConfig(LSM6DSV16X_4g, 240.0f));
+
+        failures += !check("full scale change mid-stream", decoder, segments, 2, LSM6DSV16X_4g, 240.0f);
+    }
+
+    // A full scale change and a rate change in turn, each at its own word.
+    {
+        SfeLSMFifoDecoder decoder;
+        const segment_t segments[] = {{6, 1, kRawX * 0.061f}, {4, 1, kRawX * 0.244f}, {12, 2, kRawX * 0.244f}};
+
+        decoder.setConfig(makeConfig(LSM6DSV16X_2g, 240.0f));
+        decoder.queueConfig(makeConfig(LSM6DSV16X_8g, 240.0f));
+        decoder.queueConfig(makeConfig(LSM6DSV16X_8g, 120.0f));
+
+        failures += !check("full scale then rate", decoder, segments, 3, LSM6DSV16X_8g, 120.0f);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+
+    return failures ? 1 : 0;
+}
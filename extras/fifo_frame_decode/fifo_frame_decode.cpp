@@ -0,0 +1,191 @@
+/*
+  fifo_frame_decode
+
+  Host tool that decodes the framed FIFO passthrough sent with
+    SfeLSMFifoFramer, e.g. by example12_fifo_passthrough. Reads a capture
+    file, a serial port or standard input, checks every frame and passes the
+    FIFO words through the library's FIFO decoder. Lost or damaged frames are
+    counted and the decoder is restarted after them, so the timeline is not
+    joined across a gap. By default a summary of the samples per type is
+    printed, --csv prints every sample instead.
+
+  Build on Linux or macOS from this directory:
+
+    gcc -O2 -c ../../src/st_src/lsm6dsv16x_reg.c -o lsm6dsv16x_reg.o
+    g++ -O2 -I../../src fifo_frame_decode.cpp ../../src/sfe_lsm_fifo.cpp ../../src/sfe_lsm_log.cpp \
+        ../../src/sfe_lsm_framer.cpp lsm6dsv16x_reg.o -o fifo_frame_decode
+
+  Usage, with the serial port set up beforehand, e.g. stty -F /dev/ttyACM0 raw 2000000:
+
+    fifo_frame_decode /dev/ttyACM0 [--csv]
+    fifo_frame_decode capture.bin [--csv]
+    fifo_frame_decode - [--csv] < capture.bin
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "sfe_lsm_fifo.h"
+#include "sfe_lsm_framer.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *kTypeNames[LSM_FIFO_NUM_TYPES] = {
+    "unknown",  "accel",    "gyro",       "temp",       "timestamp",   "cfg_change", "sensor_hub", "hub_nack", "steps",
+    "game_rot", "gyro_bias", "gravity",   "mlc_result", "mlc_filter", "mlc_feature", "accel_dual", "gyro_eis"};
+
+struct decode_state_t
+{
+    SfeLSMFifoDecoder decoder;
+    bool csv;
+    uint32_t lostFrames;
+    uint64_t words;
+    uint64_t counts[LSM_FIFO_NUM_TYPES];
+};
+
+static SfeLSMFifoDeframer deframer;
+
+static void onSample(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    decode_state_t *state = (decode_state_t *)context;
+
+    state->counts[sample->type]++;
+
+    if (!state->csv)
+        return;
+
+    printf("%llu,%s,%u", (unsigned long long)sample->time, kTypeNames[sample->type], sample->slot);
+
+    switch (sample->type)
+    {
+    case LSM_FIFO_ACCEL:
+    case LSM_FIFO_GYRO:
+    case LSM_FIFO_GRAVITY:
+    case LSM_FIFO_GYRO_BIAS:
+    case LSM_FIFO_SENSOR_HUB:
+        printf(",%.3f,%.3f,%.3f\n", sample->vector.xData, sample->vector.yData, sample->vector.zData);
+        break;
+    case LSM_FIFO_GAME_ROTATION:
+        printf(",%.5f,%.5f,%.5f,%.5f\n", sample->quaternion[0], sample->quaternion[1], sample->quaternion[2],
+               sample->quaternion[3]);
+        break;
+    case LSM_FIFO_TEMP:
+        printf(",%.2f\n", sample->temperature);
+        break;
+    case LSM_FIFO_TIMESTAMP:
+        printf(",%u\n", sample->timestamp);
+        break;
+    case LSM_FIFO_STEP_COUNTER:
+        printf(",%u\n", sample->stepCounter.steps);
+        break;
+    case LSM_FIFO_MLC_RESULT:
+        printf(",%u,%u\n", sample->mlcResult.index, sample->mlcResult.value);
+        break;
+    case LSM_FIFO_MLC_FILTER:
+    case LSM_FIFO_MLC_FEATURE:
+        printf(",%u,%f\n", sample->mlcFeature.id, sample->mlcFeature.value);
+        break;
+    default:
+        printf(",%d,%d,%d\n", sample->raw[0], sample->raw[1], sample->raw[2]);
+        break;
+    }
+}
+
+static void onFrame(uint8_t type, uint16_t sequence, const uint8_t *payload, uint16_t length, void *context)
+{
+    decode_state_t *state = (decode_state_t *)context;
+    sfe_lsm_fifo_config_t config;
+    int8_t odrCalibration;
+
+    // Words are missing before this frame, or the board restarted, do not join
+    // the timeline across them.
+    if (deframer.getLostFrames() != state->lostFrames || (type == LSM_FRAME_CONFIG && sequence == 0))
+    {
+        state->lostFrames = deframer.getLostFrames();
+        state->decoder.reset();
+    }
+
+    switch (type)
+    {
+    case LSM_FRAME_FIFO_WORDS: {
+        uint16_t count = length / sizeof(sfe_lsm_fifo_word_t);
+
+        state->decoder.decode((const sfe_lsm_fifo_word_t *)payload, count);
+        state->words += count;
+        break;
+    }
+    case LSM_FRAME_CONFIG:
+        if (length < kLSMLogConfigSize)
+            break;
+
+        SfeLSMFifoLogReader::unpackConfig(payload, &config, &odrCalibration);
+        state->decoder.setOdrCalibration(odrCalibration);
+        state->decoder.setConfig(config);
+        break;
+    default:
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static decode_state_t state;
+    static uint8_t buffer[65536];
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <port|file|-> [--csv]\n", argv[0]);
+        return 2;
+    }
+
+    state.csv = (argc > 2 && strcmp(argv[2], "--csv") == 0);
+
+    int fd = (strcmp(argv[1], "-") == 0) ? STDIN_FILENO : open(argv[1], O_RDONLY | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    for (uint8_t type = 0; type < LSM_FIFO_NUM_TYPES; type++)
+        state.decoder.setHandler((sfe_lsm_fifo_type_t)type, onSample, &state);
+
+    deframer.setHandler(onFrame, &state);
+
+    if (state.csv)
+        printf("time_ns,type,slot,values\n");
+
+    ssize_t length;
+
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+        deframer.push(buffer, (size_t)length);
+
+    if (length < 0)
+        perror(argv[1]);
+
+    if (!state.csv)
+    {
+        printf("%u frames, %llu words\n", deframer.getFrames(), (unsigned long long)state.words);
+
+        for (uint8_t type = 0; type < LSM_FIFO_NUM_TYPES; type++)
+        {
+            if (state.counts[type] > 0)
+                printf("%-12s %llu\n", kTypeNames[type], (unsigned long long)state.counts[type]);
+        }
+
+        printf("dropped      %u\n", state.decoder.getDroppedSamples());
+    }
+
+    if (deframer.getBadFrames() > 0 || deframer.getLostFrames() > 0)
+        fprintf(stderr, "%s: %u bad frames, %u lost frames\n", argv[1], deframer.getBadFrames(),
+                deframer.getLostFrames());
+
+    if (fd != STDIN_FILENO)
+        close(fd);
+
+    return 0;
+}
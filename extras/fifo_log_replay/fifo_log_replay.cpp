@@ -0,0 +1,158 @@
+/*
+  fifo_log_replay
+
+  Host tool that replays a FIFO log written with SfeLSMFifoLogWriter through
+    the library's FIFO decoder. The log is memory mapped, so logs of several
+    GB are walked without being copied. By default a summary of the samples
+    per type is printed, --csv prints every sample instead.
+
+  Build on Linux or macOS from this directory:
+
+    gcc -O2 -c ../../src/st_src/lsm6dsv16x_reg.c -o lsm6dsv16x_reg.o
+    g++ -O2 -I../../src fifo_log_replay.cpp ../../src/sfe_lsm_fifo.cpp ../../src/sfe_lsm_log.cpp \
+        lsm6dsv16x_reg.o -o fifo_log_replay
+
+  Usage:
+
+    fifo_log_replay capture.bin [--csv]
+
+  SparkFun code, firmware, and software is released under the MIT
+    License	(http://opensource.org/licenses/MIT).
+*/
+
+#include "sfe_lsm_fifo.h"
+#include "sfe_lsm_log.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char *kTypeNames[LSM_FIFO_NUM_TYPES] = {
+    "unknown",  "accel",    "gyro",       "temp",       "timestamp",   "cfg_change", "sensor_hub", "hub_nack", "steps",
+    "game_rot", "gyro_bias", "gravity",   "mlc_result", "mlc_filter", "mlc_feature", "accel_dual", "gyro_eis"};
+
+static uint64_t counts[LSM_FIFO_NUM_TYPES];
+
+static void onSample(const sfe_lsm_fifo_sample_t *sample, void *context)
+{
+    bool csv = *(bool *)context;
+
+    counts[sample->type]++;
+
+    if (!csv)
+        return;
+
+    printf("%llu,%s,%u", (unsigned long long)sample->time, kTypeNames[sample->type], sample->slot);
+
+    switch (sample->type)
+    {
+    case LSM_FIFO_ACCEL:
+    case LSM_FIFO_GYRO:
+    case LSM_FIFO_GRAVITY:
+    case LSM_FIFO_GYRO_BIAS:
+    case LSM_FIFO_SENSOR_HUB:
+        printf(",%.3f,%.3f,%.3f\n", sample->vector.xData, sample->vector.yData, sample->vector.zData);
+        break;
+    case LSM_FIFO_GAME_ROTATION:
+        printf(",%.5f,%.5f,%.5f,%.5f\n", sample->quaternion[0], sample->quaternion[1], sample->quaternion[2],
+               sample->quaternion[3]);
+        break;
+    case LSM_FIFO_TEMP:
+        printf(",%.2f\n", sample->temperature);
+        break;
+    case LSM_FIFO_TIMESTAMP:
+        printf(",%u\n", sample->timestamp);
+        break;
+    case LSM_FIFO_STEP_COUNTER:
+        printf(",%u\n", sample->stepCounter.steps);
+        break;
+    case LSM_FIFO_MLC_RESULT:
+        printf(",%u,%u\n", sample->mlcResult.index, sample->mlcResult.value);
+        break;
+    case LSM_FIFO_MLC_FILTER:
+    case LSM_FIFO_MLC_FEATURE:
+        printf(",%u,%f\n", sample->mlcFeature.id, sample->mlcFeature.value);
+        break;
+    default:
+        printf(",%d,%d,%d\n", sample->raw[0], sample->raw[1], sample->raw[2]);
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool csv = (argc > 2 && strcmp(argv[2], "--csv") == 0);
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s capture.bin [--csv]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat info;
+
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    if (info.st_size == 0)
+    {
+        fprintf(stderr, "%s: empty file\n", argv[1]);
+        return 1;
+    }
+
+    void *map = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (map == MAP_FAILED)
+    {
+        perror("mmap");
+        return 1;
+    }
+
+    madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+    SfeLSMFifoLogReader reader;
+
+    if (!reader.open((const uint8_t *)map, (size_t)info.st_size))
+    {
+        fprintf(stderr, "%s: not a FIFO log\n", argv[1]);
+        return 1;
+    }
+
+    SfeLSMFifoDecoder decoder;
+
+    for (uint8_t type = 0; type < LSM_FIFO_NUM_TYPES; type++)
+        decoder.setHandler((sfe_lsm_fifo_type_t)type, onSample, &csv);
+
+    if (csv)
+        printf("time_ns,type,slot,values\n");
+
+    uint64_t words = reader.replay(decoder);
+
+    if (!csv)
+    {
+        printf("log version %u, %llu words\n", reader.getVersion(), (unsigned long long)words);
+
+        for (uint8_t type = 0; type < LSM_FIFO_NUM_TYPES; type++)
+        {
+            if (counts[type] > 0)
+                printf("%-12s %llu\n", kTypeNames[type], (unsigned long long)counts[type]);
+        }
+
+        printf("dropped      %u\n", decoder.getDroppedSamples());
+    }
+
+    if (reader.isTruncated())
+        fprintf(stderr, "%s: log ends inside a record\n", argv[1]);
+
+    munmap(map, (size_t)info.st_size);
+    close(fd);
+
+    return 0;
+}
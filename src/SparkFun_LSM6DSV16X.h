@@ -1,5 +1,7 @@
 #pragma once
 #include "sfe_lsm6dsv16x.h"
+#include "sfe_lsm_log.h"
+#include "sfe_lsm_framer.h"
 #include "sfe_bus.h"
 #include <Wire.h>
 #include <SPI.h>
@@ -1,4 +1,5 @@
 #include "sfe_bus.h"
+#include "st_src/lsm6dsv16x_reg.h"
 #include <Arduino.h>
 
 #define kMaxTransferBuffer 32
@@ -7,6 +8,12 @@
 // What we use for transfer chunk size
 const static uint16_t kChunkSize = kMaxTransferBuffer;
 
+// FIFO words are read from the 7 byte FIFO_DATA_OUT window, which the device
+// rolls back to LSM6DSV16X_FIFO_DATA_OUT_TAG after the last byte. FIFO bursts
+// are chunked on whole words and the register is not advanced between chunks.
+#define kFifoWordSize 7
+const static uint16_t kFifoChunkSize = (kChunkSize / kFifoWordSize) * kFifoWordSize;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor
 //
@@ -111,6 +118,9 @@ int QwI2C::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t
         // We're chunking in data - keeping the max chunk to kMaxI2CBufferLength
         nChunk = numBytes > kChunkSize ? kChunkSize : numBytes;
 
+        if (reg == LSM6DSV16X_FIFO_DATA_OUT_TAG && nChunk > kFifoChunkSize)
+            nChunk = kFifoChunkSize;
+
         nReturned = _i2cPort->requestFrom((int)addr, (int)nChunk, (int)true);
 
         // No data returned, no dice
@@ -126,7 +136,8 @@ int QwI2C::readRegisterRegion(uint8_t addr, uint8_t reg, uint8_t *data, uint16_t
         numBytes = numBytes - nReturned;
 
 				// Move the register to the number of registers read. 
-				reg += nReturned; 
+				if (reg != LSM6DSV16X_FIFO_DATA_OUT_TAG)
+					reg += nReturned; 
 
     } // end while
 
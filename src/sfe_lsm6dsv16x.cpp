@@ -14,6 +14,16 @@ bool QwDevLSM6DSV16X::init(void)
     if (getUniqueId() != LSM6DSV16X_ID)
         return false;
 
+    // The device keeps its interrupt routes across an MCU reset, start the
+    // copy getEnabledInterrupts() works from with what it holds.
+    sfe_lsm_int_plan_t plan;
+
+    if (!getIntRoutePlan(&plan))
+        return false;
+
+    intRoute[0] = plan.int1;
+    intRoute[1] = plan.int2;
+
     return true;
 }
 
@@ -78,6 +88,8 @@ bool QwDevLSM6DSV16X::setAccelFullScale(lsm6dsv16x_xl_full_scale_t scale)
 
     fullScaleAccel = scale;
     accelScaleSet = true;
+    invalidateReadCache(LSM_CACHE_ACCEL);
+    updateFifoConfig();
 
     if (retVal != 0)
         return false;
@@ -101,6 +113,8 @@ bool QwDevLSM6DSV16X::setGyroFullScale(lsm6dsv16x_gy_full_scale_t scale)
 
     fullScaleGyro = scale;
     gyroScaleSet = true;
+    invalidateReadCache(LSM_CACHE_GYRO);
+    updateFifoConfig();
 
     if (retVal != 0)
         return false;
@@ -155,11 +169,13 @@ uint8_t QwDevLSM6DSV16X::getUniqueId()
 /// @return Returns raw temperature value.
 bool QwDevLSM6DSV16X::getRawTemp(int16_t *tempVal)
 {
-    int32_t retVal = lsm6dsv16x_temperature_raw_get(&sfe_dev, tempVal);
+    const int16_t *raw = readRawWords(0, LSM6DSV16X_OUT_TEMP_L, 1);
 
-    if (retVal != 0)
+    if (raw == nullptr)
         return false;
 
+    *tempVal = raw[0];
+
     return true;
 }
 
@@ -168,15 +184,14 @@ bool QwDevLSM6DSV16X::getRawTemp(int16_t *tempVal)
 /// @return True on successful execution.
 bool QwDevLSM6DSV16X::getRawAccel(sfe_lsm_raw_data_t *accelData)
 {
-    int16_t tempVal[3] = {0};
-    int32_t retVal = lsm6dsv16x_acceleration_raw_get(&sfe_dev, tempVal);
+    const int16_t *raw = readRawWords(1, LSM6DSV16X_OUTX_L_A, 3);
 
-    if (retVal != 0)
+    if (raw == nullptr)
         return false;
 
-    accelData->xData = tempVal[0];
-    accelData->yData = tempVal[1];
-    accelData->zData = tempVal[2];
+    accelData->xData = raw[0];
+    accelData->yData = raw[1];
+    accelData->zData = raw[2];
 
     return true;
 }
@@ -186,20 +201,136 @@ bool QwDevLSM6DSV16X::getRawAccel(sfe_lsm_raw_data_t *accelData)
 /// @return True on successful execution.
 bool QwDevLSM6DSV16X::getRawGyro(sfe_lsm_raw_data_t *gyroData)
 {
+    const int16_t *raw = readRawWords(2, LSM6DSV16X_OUTX_L_G, 3);
+
+    if (raw == nullptr)
+        return false;
 
-    int16_t tempVal[3] = {0};
-    int32_t retVal = lsm6dsv16x_angular_rate_raw_get(&sfe_dev, tempVal);
+    gyroData->xData = raw[0];
+    gyroData->yData = raw[1];
+    gyroData->zData = raw[2];
 
-    if (retVal != 0)
+    return true;
+}
+
+/// @brief Reads the gyroscope and accelerometer output registers in a single
+/// burst. The result is left in the receive buffer: getBurstTriplets() returns
+/// two triplets, gyroscope first and accelerometer second.
+/// @return True on successful execution.
+bool QwDevLSM6DSV16X::readRawAccelGyro()
+{
+    if (readBurst(LSM6DSV16X_OUTX_L_G, 12, LSM_BURST_TRIPLETS) != 0)
         return false;
 
-    gyroData->xData = tempVal[0];
-    gyroData->yData = tempVal[1];
-    gyroData->zData = tempVal[2];
+    // Both channels are now fresh, so let the cache reuse them.
+    cacheStore(2, &rxBuffer.words[0], 3);
+    cacheStore(1, &rxBuffer.words[3], 3);
 
     return true;
 }
 
+/// @brief Retrieves the raw bytes of the last burst.
+/// @param length Set to the number of bytes in the burst.
+/// @return Pointer into the receive buffer, or nullptr if nothing has been read.
+const uint8_t *QwDevLSM6DSV16X::getBurstBytes(uint16_t *length)
+{
+    *length = rxLength;
+
+    if (rxKind == LSM_BURST_NONE)
+        return nullptr;
+
+    return rxBuffer.bytes;
+}
+
+/// @brief Retrieves the last burst as signed 16-bit values grouped in x/y/z
+/// triplets, in host byte order.
+/// @param count Set to the number of triplets in the burst.
+/// @return Pointer into the receive buffer, or nullptr if the last burst was not
+/// output register data.
+const int16_t *QwDevLSM6DSV16X::getBurstTriplets(uint16_t *count)
+{
+    if (rxKind != LSM_BURST_TRIPLETS)
+    {
+        *count = 0;
+        return nullptr;
+    }
+
+    *count = rxLength / 6;
+
+    return rxBuffer.words;
+}
+
+/// @brief Retrieves the last burst as tagged FIFO words.
+/// @param count Set to the number of words in the burst.
+/// @return Pointer into the receive buffer, or nullptr if the last burst was
+/// not a FIFO read.
+const sfe_lsm_fifo_word_t *QwDevLSM6DSV16X::getBurstFifoWords(uint16_t *count)
+{
+    if (rxKind != LSM_BURST_FIFO)
+    {
+        *count = 0;
+        return nullptr;
+    }
+
+    *count = rxLength / sizeof(sfe_lsm_fifo_word_t);
+
+    return rxBuffer.fifo;
+}
+
+/// @brief Reads a block of registers into the receive buffer.
+/// @param reg The first register to read.
+/// @param length The number of bytes, at most SFE_LSM6DSV16X_RX_BUFFER_SIZE.
+/// @param kind How the views should present the data.
+/// @return The successful (0) or unsuccessful (-1) read.
+int32_t QwDevLSM6DSV16X::readBurst(uint8_t reg, uint16_t length, sfe_lsm_burst_t kind)
+{
+    if (length > SFE_LSM6DSV16X_RX_BUFFER_SIZE)
+        return -1;
+
+    rxKind = LSM_BURST_NONE;
+
+    if (readRegisterRegion(reg, rxBuffer.bytes, length) != 0)
+        return -1;
+
+#if DRV_BYTE_ORDER == DRV_BIG_ENDIAN
+    // Output registers are little endian, swap in place so the triplet view
+    // can be used directly.
+    if (kind == LSM_BURST_TRIPLETS)
+    {
+        for (uint16_t i = 0; i + 1 < length; i += 2)
+        {
+            uint8_t low = rxBuffer.bytes[i];
+            rxBuffer.bytes[i] = rxBuffer.bytes[i + 1];
+            rxBuffer.bytes[i + 1] = low;
+        }
+    }
+#endif
+
+    rxLength = length;
+    rxKind = kind;
+
+    return 0;
+}
+
+/// @brief Returns the raw output register values of one channel, either from
+/// the read cache or from a fresh burst into the receive buffer.
+/// @param cacheIndex Cache slot: 0 temperature, 1 accelerometer, 2 gyroscope.
+/// @param reg The channel's first output register.
+/// @param count The number of 16-bit values in the channel.
+/// @return Pointer to the values, or nullptr on a bus error.
+const int16_t *QwDevLSM6DSV16X::readRawWords(uint8_t cacheIndex, uint8_t reg, uint8_t count)
+{
+    if (cacheLookup(cacheIndex))
+        return cacheData[cacheIndex];
+
+    if (readBurst(reg, count * 2, LSM_BURST_TRIPLETS) != 0)
+        return nullptr;
+
+    cacheStore(cacheIndex, rxBuffer.words, count);
+
+    return rxBuffer.words;
+}
+
 /// @brief Retrieves raw register values for gyroscope data
 /// @param qvarData Raw analog data from the register.
 /// @return True on successful execution.
@@ -221,14 +352,16 @@ bool QwDevLSM6DSV16X::getRawQvar(int16_t *qvarData)
 bool QwDevLSM6DSV16X::getAccel(sfe_lsm_data_t *accelData)
 {
 
-    int16_t tempVal[3] = {0};
+    const int16_t *tempVal;
     int32_t retVal;
 
-    retVal = lsm6dsv16x_acceleration_raw_get(&sfe_dev, tempVal);
+    tempVal = readRawWords(1, LSM6DSV16X_OUTX_L_A, 3);
+    retVal = (tempVal != nullptr) ? 0 : -1;
 
     if (accelScaleSet == false)
     {
         getAccelFullScale(&fullScaleAccel);
+        fifoDecoder.setAccelFullScale(fullScaleAccel);
         accelScaleSet = true;
     }
 
@@ -274,13 +407,15 @@ bool QwDevLSM6DSV16X::getGyro(sfe_lsm_data_t *gyroData)
 {
 
     int32_t retVal;
-    int16_t tempVal[3] = {0};
+    const int16_t *tempVal;
 
-    retVal = lsm6dsv16x_angular_rate_raw_get(&sfe_dev, tempVal);
+    tempVal = readRawWords(2, LSM6DSV16X_OUTX_L_G, 3);
+    retVal = (tempVal != nullptr) ? 0 : -1;
 
     if (gyroScaleSet == false)
     {
         getGyroFullScale(&fullScaleGyro);
+        fifoDecoder.setGyroFullScale(fullScaleGyro);
         gyroScaleSet = true;
     }
 
@@ -432,6 +567,12 @@ bool QwDevLSM6DSV16X::deviceReset()
     }
 
     accelScaleSet = false;
+    accelRate = LSM6DSV16X_ODR_OFF;
+    gyroRate = LSM6DSV16X_ODR_OFF;
+    updateCachePeriods();
+
+    intRoute[0] = {};
+    intRoute[1] = {};
 
     return true;
 }
@@ -490,6 +631,7 @@ bool QwDevLSM6DSV16X::setAccelMode(lsm6dsv16x_xl_mode_t mode)
     int32_t retVal;
 
     retVal = lsm6dsv16x_xl_mode_set(&sfe_dev, mode);
+    invalidateReadCache(LSM_CACHE_ACCEL);
 
     if (retVal != 0)
         return false;
@@ -510,6 +652,7 @@ bool QwDevLSM6DSV16X::setGyroMode(lsm6dsv16x_gy_mode_t mode)
     int32_t retVal;
 
     retVal = lsm6dsv16x_gy_mode_set(&sfe_dev, mode);
+    invalidateReadCache(LSM_CACHE_GYRO);
 
     if (retVal != 0)
         return false;
@@ -728,6 +871,10 @@ bool QwDevLSM6DSV16X::setAccelDataRate(lsm6dsv16x_data_rate_t rate)
     if (retVal != 0)
         return false;
 
+    accelRate = rate;
+    updateCachePeriods();
+    updateFifoConfig();
+
     return true;
 }
 
@@ -776,6 +923,10 @@ bool QwDevLSM6DSV16X::setGyroDataRate(lsm6dsv16x_data_rate_t rate)
     if (retVal != 0)
         return false;
 
+    gyroRate = rate;
+    updateCachePeriods();
+    updateFifoConfig();
+
     return true;
 }
 
@@ -794,6 +945,174 @@ bool QwDevLSM6DSV16X::enableTimestamp(bool enable)
     return true;
 }
 
+/// Read Cache//////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Converts an output data rate setting to its nominal frequency.
+/// @param rate The output data rate setting.
+/// @return The output data rate in Hz, zero when powered down.
+static float dataRateToHz(lsm6dsv16x_data_rate_t rate)
+{
+    // Nominal rates for the ODR field, the high-accuracy sets scale these.
+    static const float baseHz[13] = {0.0f,   1.875f,  7.5f,    15.0f,   30.0f,   60.0f,  120.0f,
+                                     240.0f, 480.0f, 960.0f, 1920.0f, 3840.0f, 7680.0f};
+    uint8_t odr = (uint8_t)rate & 0x0F;
+    uint8_t haSel = ((uint8_t)rate >> 4) & 0x03;
+
+    if (odr > 12)
+        return 0.0f;
+
+    if (haSel == 1)
+        return baseHz[odr] * (8000.0f / 7680.0f);
+    if (haSel == 2)
+        return baseHz[odr] * (6400.0f / 7680.0f);
+
+    return baseHz[odr];
+}
+
+/// @brief Enables or disables the read cache for the given channels. While
+/// enabled, a channel read again within one output period, with no new sample
+/// flagged in STATUS_REG, is answered from the last value read. The cache is
+/// dropped when the channel's full scale, rate or mode changes. The output periods are
+/// derived from the data rates set with setAccelDataRate() and setGyroDataRate(),
+/// trimmed by the device's ODR calibration.
+/// @param channels The channels to change, LSM_CACHE_TEMP, LSM_CACHE_ACCEL and/or LSM_CACHE_GYRO.
+/// @param enable Enable/disable caching of the channels.
+/// @return True on successful execution.
+bool QwDevLSM6DSV16X::enableReadCache(uint8_t channels, bool enable)
+{
+    int32_t retVal;
+
+    if (enable)
+    {
+        // The rates may have been set before the cache was in use, or by a
+        // previous session, so take them from the device.
+        retVal = lsm6dsv16x_xl_data_rate_get(&sfe_dev, &accelRate);
+        retVal += lsm6dsv16x_gy_data_rate_get(&sfe_dev, &gyroRate);
+        retVal += lsm6dsv16x_odr_cal_reg_get(&sfe_dev, &odrCalibration);
+
+        if (retVal != 0)
+            return false;
+
+        cacheEnabled |= (channels & LSM_CACHE_ALL);
+    }
+    else
+    {
+        cacheEnabled &= ~channels;
+    }
+
+    invalidateReadCache(channels);
+    updateCachePeriods();
+
+    return true;
+}
+
+/// @brief Discards cached values so that the next read of each channel goes to the device.
+/// @param channels The channels to refresh on their next read.
+void QwDevLSM6DSV16X::invalidateReadCache(uint8_t channels)
+{
+    cacheValid &= ~channels;
+}
+
+/// @brief Retrieves the hit and miss counts for one cached channel.
+/// @param channel LSM_CACHE_TEMP, LSM_CACHE_ACCEL or LSM_CACHE_GYRO
+/// @return The statistics for the channel.
+sfe_lsm_cache_stats_t QwDevLSM6DSV16X::getReadCacheStats(sfe_lsm_cache_channel_t channel)
+{
+    switch (channel)
+    {
+    case LSM_CACHE_TEMP:
+        return cacheStats[0];
+    case LSM_CACHE_ACCEL:
+        return cacheStats[1];
+    case LSM_CACHE_GYRO:
+        return cacheStats[2];
+    default:
+        break;
+    }
+
+    sfe_lsm_cache_stats_t none = {0, 0};
+    return none;
+}
+
+/// @brief Clears the hit and miss counts of every channel.
+void QwDevLSM6DSV16X::resetReadCacheStats()
+{
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        cacheStats[i].hits = 0;
+        cacheStats[i].misses = 0;
+    }
+}
+
+/// @brief Checks whether a cached channel value is younger than one output
+/// period and the device has no newer sample. The period counts from the read,
+/// not from the sample, so the data ready bit in STATUS_REG has the last word:
+/// a hit costs one status byte instead of the whole channel.
+/// @param index Cache slot: 0 temperature, 1 accelerometer, 2 gyroscope.
+/// @return True if the value in cacheData can be served.
+bool QwDevLSM6DSV16X::cacheLookup(uint8_t index)
+{
+    uint8_t mask = (1 << index);
+
+    if ((cacheEnabled & mask) == 0)
+        return false;
+
+    if ((cacheValid & mask) && (micros() - cacheStamp[index]) < cachePeriodUs[index])
+    {
+        // XLDA, GDA and TDA in bits 0 to 2
+        static const uint8_t kReadyBit[3] = {0x04, 0x01, 0x02};
+        uint8_t status;
+
+        if (readRegisterRegion(LSM6DSV16X_STATUS_REG, &status, 1) == 0 && (status & kReadyBit[index]) == 0)
+        {
+            cacheStats[index].hits++;
+            return true;
+        }
+    }
+
+    cacheStats[index].misses++;
+    return false;
+}
+
+/// @brief Saves a freshly read channel value in the cache.
+/// @param index Cache slot: 0 temperature, 1 accelerometer, 2 gyroscope.
+/// @param data The value read from the device.
+/// @param length The number of values in the channel.
+void QwDevLSM6DSV16X::cacheStore(uint8_t index, const int16_t *data, uint8_t length)
+{
+    uint8_t mask = (1 << index);
+
+    if ((cacheEnabled & mask) == 0)
+        return;
+
+    for (uint8_t i = 0; i < length; i++)
+        cacheData[index][i] = data[i];
+
+    cacheStamp[index] = micros();
+    cacheValid |= mask;
+}
+
+/// @brief Recomputes each channel's output period from the current data rates.
+/// A period of zero disables caching for that channel.
+void QwDevLSM6DSV16X::updateCachePeriods()
+{
+    // Effective ODR = nominal * (1 + 0.13% * INTERNAL_FREQ)
+    float trim = 1.0f + (0.0013f * (float)odrCalibration);
+    float accelHz = dataRateToHz(accelRate) * trim;
+    float gyroHz = dataRateToHz(gyroRate) * trim;
+
+    // The temperature sensor follows the faster of the two sensors, capped at 60Hz.
+    float tempHz = (accelHz > gyroHz) ? accelHz : gyroHz;
+    if (tempHz > 60.0f * trim)
+        tempHz = 60.0f * trim;
+
+    cachePeriodUs[0] = (tempHz > 0.0f) ? (uint32_t)(1000000.0f / tempHz) : 0;
+    cachePeriodUs[1] = (accelHz > 0.0f) ? (uint32_t)(1000000.0f / accelHz) : 0;
+    cachePeriodUs[2] = (gyroHz > 0.0f) ? (uint32_t)(1000000.0f / gyroHz) : 0;
+
+    cacheValid = 0;
+}
+
 /// FIFO Settting//////////////////////////////////////////////////////////////////////////////////
 
 /// @brief Sets the FIFO's watermark threshold.
@@ -808,6 +1127,8 @@ bool QwDevLSM6DSV16X::setFifoWatermark(uint8_t val)
     if (retVal != 0)
         return false;
 
+    fifoWatermark = val;
+
     return true;
 }
 
@@ -830,6 +1151,17 @@ bool QwDevLSM6DSV16X::setFifoMode(lsm6dsv16x_fifo_mode_t mode)
     if (retVal != 0)
         return false;
 
+    fifoMode = mode;
+
+    // Bypass mode empties the FIFO, nothing queued refers to earlier words.
+    if (mode == LSM6DSV16X_BYPASS_MODE)
+    {
+        fifoDecoder.reset();
+
+        if (fifoLog != nullptr)
+            fifoLog->writeReset(millis());
+    }
+
     return true;
 }
 
@@ -858,7 +1190,9 @@ bool QwDevLSM6DSV16X::setAccelFifoBatchSet(lsm6dsv16x_fifo_xl_batch_t odr)
     if (retVal != 0)
         return false;
 
-    return true;
+    accelBatch = odr;
+
+    return updateFifoTiming();
 }
 
 /// @brief FIFO Batch data rate selection for the gyroscope
@@ -886,9 +1220,85 @@ bool QwDevLSM6DSV16X::setGyroFifoBatchSet(lsm6dsv16x_fifo_gy_batch_t odr)
     if (retVal != 0)
         return false;
 
+    gyroBatch = odr;
+
+    return updateFifoTiming();
+}
+
+/// @brief Passes the batch rates and the ODR calibration on to the FIFO
+/// decoder, which needs them to assign a time to every sample.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::updateFifoTiming()
+{
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_odr_cal_reg_get(&sfe_dev, &odrCalibration);
+
+    if (retVal != 0)
+        return false;
+
+    bool calibrationChanged = (odrCalibration != fifoDecoder.getOdrCalibration());
+
+    fifoDecoder.setOdrCalibration(odrCalibration);
+    updateFifoConfig(calibrationChanged);
+
     return true;
 }
 
+/// @brief Passes the full scales and batch rates on to the FIFO decoder. While
+/// the FIFO batches with CFG_CHANGE words enabled, the words already in the FIFO
+/// were taken with the old settings, so the decoder only applies new ones from
+/// the CFG_CHANGE word on. Calls that leave the settings as they were, e.g.
+/// enableTimestamp(), queue nothing. Changes made without these setters are not
+/// seen by the decoder. Changes are logged to the writer set with setFifoLog().
+/// @param calibrationChanged Log the settings even if only the ODR calibration changed.
+void QwDevLSM6DSV16X::updateFifoConfig(bool calibrationChanged)
+{
+    sfe_lsm_fifo_config_t config;
+    sfe_lsm_fifo_config_t current = fifoDecoder.getConfig();
+    bool queued = false;
+    bool changed;
+
+    // Batch rates share the ODR field coding, the high-accuracy set of the
+    // sensor scales them the same way. A sensor running slower than its batch
+    // rate is batched at its ODR.
+    float accelHz = dataRateToHz((lsm6dsv16x_data_rate_t)(accelBatch | (accelRate & 0x30)));
+    float gyroHz = dataRateToHz((lsm6dsv16x_data_rate_t)(gyroBatch | (gyroRate & 0x30)));
+    float accelOdrHz = dataRateToHz(accelRate);
+    float gyroOdrHz = dataRateToHz(gyroRate);
+
+    if (accelOdrHz > 0.0f && accelOdrHz < accelHz)
+        accelHz = accelOdrHz;
+    if (gyroOdrHz > 0.0f && gyroOdrHz < gyroHz)
+        gyroHz = gyroOdrHz;
+
+    config.accelScale = fullScaleAccel;
+    config.gyroScale = fullScaleGyro;
+    config.accelBatchHz = accelHz;
+    config.gyroBatchHz = gyroHz;
+
+    // Scales that were never set or read are left as the decoder has them.
+    if (!accelScaleSet)
+        config.accelScale = current.accelScale;
+    if (!gyroScaleSet)
+        config.gyroScale = current.gyroScale;
+
+    if (fifoConfigChange && fifoMode != LSM6DSV16X_BYPASS_MODE)
+    {
+        queued = fifoDecoder.queueConfig(config);
+        changed = queued;
+    }
+    else
+    {
+        changed = (config.accelScale != current.accelScale || config.gyroScale != current.gyroScale ||
+                   config.accelBatchHz != current.accelBatchHz || config.gyroBatchHz != current.gyroBatchHz);
+        fifoDecoder.setConfig(config);
+    }
+
+    if (fifoLog != nullptr && (changed || calibrationChanged))
+        fifoLog->writeConfig(config, odrCalibration, queued, millis());
+}
+
 /// @brief Selects decimation for timestamp batching in FIFO
 /// @param decimation timestamp decimation for FIFO
 ///		LSM6DSV16X_TMSTMP_NOT_BATCHED
@@ -908,17 +1318,19 @@ bool QwDevLSM6DSV16X::setFifoTimestampDec(lsm6dsv16x_fifo_timestamp_batch_t deci
     return true;
 }
 
-////Interrupt Settings//////////////////////////////////////////////////////////////////////////////
-
-/// @brief Retrieves all interrupt source bits
-/// @param source interrupt bits
+/// @brief Batches the temperature into the FIFO, processFifo() then delivers
+/// it as LSM_FIFO_TEMP samples in degrees C.
+/// @param rate The temperature batch rate:
+///		LSM6DSV16X_TEMP_NOT_BATCHED
+///		LSM6DSV16X_TEMP_BATCHED_AT_1Hz875
+///		LSM6DSV16X_TEMP_BATCHED_AT_15Hz
+///		LSM6DSV16X_TEMP_BATCHED_AT_60Hz
 /// @return True on successful execution
-bool QwDevLSM6DSV16X::getAllInterrupts(lsm6dsv16x_all_sources_t *source)
+bool QwDevLSM6DSV16X::setTempFifoBatch(lsm6dsv16x_fifo_temp_batch_t rate)
 {
-    int32_t retVal = 0;
+    int32_t retVal;
 
-    // 0 = active high :  active low, 1
-    retVal = lsm6dsv16x_all_sources_get(&sfe_dev, source);
+    retVal = lsm6dsv16x_fifo_temp_batch_set(&sfe_dev, rate);
 
     if (retVal != 0)
         return false;
@@ -926,15 +1338,15 @@ bool QwDevLSM6DSV16X::getAllInterrupts(lsm6dsv16x_all_sources_t *source)
     return true;
 }
 
-/// @brief Sets the active state of the interrupt pin - high or low.
-/// @param activeLow Enable/disable active low interrupts
+/// @brief Batches the step count into the FIFO each time a step is detected,
+/// delivered as LSM_FIFO_STEP_COUNTER samples. Needs enableStepCounter().
+/// @param enable Enables/disables step counter batching
 /// @return True on successful execution
-bool QwDevLSM6DSV16X::setInt2DENActiveLow(bool activeLow)
+bool QwDevLSM6DSV16X::setStepCounterFifoBatch(bool enable)
 {
-    int32_t retVal = 0;
+    int32_t retVal;
 
-    // 0 = active high :  active low, 1
-    retVal = lsm6dsv16x_den_polarity_set(&sfe_dev, (lsm6dsv16x_den_polarity_t)activeLow);
+    retVal = lsm6dsv16x_fifo_stpcnt_batch_set(&sfe_dev, (uint8_t)enable);
 
     if (retVal != 0)
         return false;
@@ -942,18 +1354,15 @@ bool QwDevLSM6DSV16X::setInt2DENActiveLow(bool activeLow)
     return true;
 }
 
-/// @brief Selects the signal that will be routed to the selected interrupt.
-/// @param val The interrupt to route.
-/// @param pin The pin to route to.
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntRoute(lsm6dsv16x_pin_int_route_t val, sfe_lsm_pin_t pin)
+/// @brief Batches the machine learning core results into the FIFO each time a
+/// decision tree changes its output, delivered as LSM_FIFO_MLC_RESULT samples.
+/// @param enable Enables/disables MLC result batching
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setMLCFifoBatch(bool enable)
 {
-    int32_t retVal = 0;
+    int32_t retVal;
 
-    if (pin == LSM_PIN_ONE)
-        retVal = lsm6dsv16x_pin_int1_route_set(&sfe_dev, &val);
-    if (pin == LSM_PIN_TWO)
-        retVal = lsm6dsv16x_pin_int2_route_set(&sfe_dev, &val);
+    retVal = lsm6dsv16x_fifo_mlc_batch_set(&sfe_dev, (uint8_t)enable);
 
     if (retVal != 0)
         return false;
@@ -961,127 +1370,2208 @@ bool QwDevLSM6DSV16X::setIntRoute(lsm6dsv16x_pin_int_route_t val, sfe_lsm_pin_t
     return true;
 }
 
-/// @brief Routes the data ready signal for the accelerometer to the selected pin.
-/// @param pin the interrupt pin
-/// @param enable enable/disable accelerometer data ready interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntAccelDataReady(sfe_lsm_pin_t pin, bool enable)
+/// @brief Batches the machine learning core filter and feature outputs into
+/// the FIFO, delivered as LSM_FIFO_MLC_FILTER and LSM_FIFO_MLC_FEATURE samples.
+/// @param enable Enables/disables MLC filter and feature batching
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setMLCFilterFifoBatch(bool enable)
 {
+    int32_t retVal;
 
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.drdy_xl = (uint8_t)enable;
+    retVal = lsm6dsv16x_fifo_mlc_filt_batch_set(&sfe_dev, (uint8_t)enable);
 
-    if (setIntRoute(int_route, pin))
-        return true;
+    if (retVal != 0)
+        return false;
 
-    return false;
+    return true;
 }
 
-/// @brief Routes the data ready signal for the Gyroscope to the selected pin.
-/// @param pin the interrupt pin
-/// @param enable enable/disable gyroscope data ready interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntGyroDataReady(sfe_lsm_pin_t pin, bool enable)
+/// @brief Enables real-time FIFO compression of accelerometer and gyroscope
+/// words. Depending on how much consecutive samples differ each word then
+/// holds one, two or three samples, processFifo() reconstructs them.
+/// @param enable Enables/disables compression
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::enableFifoCompression(bool enable)
 {
+    int32_t retVal;
 
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.drdy_g = (uint8_t)enable;
+    retVal = lsm6dsv16x_fifo_compress_algo_real_time_set(&sfe_dev, (uint8_t)enable);
 
-    if (setIntRoute(int_route, pin))
-        return true;
+    if (retVal != 0)
+        return false;
 
-    return false;
+    return true;
 }
 
-/// @brief Enables the single tap interrupt on the selected interrupt pin.
-/// @param pin the interrupt pin
-/// @param enable enable/disable single tap interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntSingleTap(sfe_lsm_pin_t pin, bool enable)
+/// @brief Forces an uncompressed word every N batched samples, this bounds how
+/// far a lost or corrupted word can propagate into the reconstructed samples.
+/// @param rate The uncompressed word rate:
+///		LSM6DSV16X_CMP_DISABLE
+///		LSM6DSV16X_CMP_8_TO_1
+///		LSM6DSV16X_CMP_16_TO_1
+///		LSM6DSV16X_CMP_32_TO_1
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setFifoUncompressedRate(lsm6dsv16x_fifo_compress_algo_t rate)
 {
+    int32_t retVal;
 
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.single_tap = (uint8_t)enable;
+    retVal = lsm6dsv16x_fifo_compress_algo_set(&sfe_dev, rate);
 
-    if (setIntRoute(int_route, pin))
-        return true;
+    if (retVal != 0)
+        return false;
 
     return true;
 }
 
-/// @brief Enables the double tap interrupt on the selected interrupt pin.
-/// @param pin the interrupt pin
-/// @param enable enable/disable double tap interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntDoubleTap(sfe_lsm_pin_t pin, bool enable)
+/// @brief Batches a CFG_CHANGE word whenever the full scale, ODR or batch rate
+/// of a sensor changes. With these enabled, settings changed through this class
+/// while the FIFO is running only apply to the samples batched after the change,
+/// the samples already in the FIFO are still converted with the old ones.
+/// @param enable Enables/disables the CFG_CHANGE words
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::enableFifoConfigChange(bool enable)
 {
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.double_tap = (uint8_t)enable;
+    int32_t retVal;
 
-    if (setIntRoute(int_route, pin))
-        return true;
+    retVal = lsm6dsv16x_fifo_virtual_sens_odr_chg_set(&sfe_dev, (uint8_t)enable);
 
-    return false;
+    if (retVal != 0)
+        return false;
+
+    fifoConfigChange = enable;
+
+    return true;
 }
 
-/// @brief Enables the wake up interrupt on the selected interrupt pin.
-/// @param pin the interrupt pin
-/// @param enable enable/disable wakeup interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntWakeup(sfe_lsm_pin_t pin, bool enable)
+/// @brief Retrieves the number of unread FIFO words and the FIFO flags.
+/// @param status The FIFO level and the watermark, overrun, full and batch counter flags.
+/// @return True on successful executuion
+bool QwDevLSM6DSV16X::getFifoStatus(lsm6dsv16x_fifo_status_t *status)
 {
+    int32_t retVal;
 
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.wakeup = (uint8_t)enable;
+    retVal = lsm6dsv16x_fifo_status_get(&sfe_dev, status);
 
-    if (setIntRoute(int_route, pin))
-        return true;
+    if (retVal != 0)
+        return false;
 
-    return false;
+    return true;
 }
 
-/// @brief Enables the free fall interrupt on one of the interrupt pins.
-/// @param pin the interrupt pin
-/// @param enable enable/disable freefall interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntFreeFall(sfe_lsm_pin_t pin, bool enable)
+/// @brief Reads the FIFO level ahead of a drain and records it, together with
+/// the overrun and full flags, in the FIFO statistics.
+/// @param level Set to the number of unread words.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::readFifoLevel(uint16_t *level)
 {
+    lsm6dsv16x_fifo_status_t status;
 
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.freefall = (uint8_t)enable;
+    if (!getFifoStatus(&status))
+        return false;
 
-    if (setIntRoute(int_route, pin))
-        return true;
+    *level = status.fifo_level;
 
-    return false;
-}
+    if (status.fifo_ovr)
+        fifoStats.overruns++;
+    if (status.fifo_full)
+        fifoStats.fullEvents++;
 
-/// @brief Enables the sleep change interrupt on one of the interrupt pins.
+    fifoStats.lastLevel = status.fifo_level;
+    if (status.fifo_level > fifoStats.peakLevel)
+        fifoStats.peakLevel = status.fifo_level;
+
+    if (status.fifo_level > 0)
+        fifoStats.drains++;
+
+    return true;
+}
+
+/// @brief Returns the FIFO statistics collected since the last resetFifoStats().
+/// Dropped samples are counted by the FIFO decoder on every word it walks, see
+/// sfe_lsm_fifo_stats_t.
+/// @return The statistics
+sfe_lsm_fifo_stats_t QwDevLSM6DSV16X::getFifoStats()
+{
+    sfe_lsm_fifo_stats_t stats = fifoStats;
+
+    stats.droppedSamples = fifoDecoder.getDroppedSamples();
+
+    return stats;
+}
+
+/// @brief Clears the FIFO statistics.
+void QwDevLSM6DSV16X::resetFifoStats()
+{
+    fifoStats = {};
+    watermarkOverruns = 0;
+    fifoDecoder.resetDroppedSamples();
+}
+
+/// @brief Lets serviceFifoStream() retune the FIFO watermark after every drain.
+/// The words that arrive between the watermark interrupt and the drain measure
+/// the drain latency, the watermark is set as high as possible while twice the
+/// recent peak of those words still fits below maxFill. A higher watermark means
+/// fewer interrupts, an overrun drops it back to the minimum.
+/// @param minWatermark Lowest watermark in words, also the starting point.
+/// @param maxWatermark Highest watermark in words, at most the stream buffer size.
+/// @param maxFill The FIFO level in words that drains should stay under.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::enableAdaptiveWatermark(uint8_t minWatermark, uint8_t maxWatermark, uint16_t maxFill)
+{
+    if (minWatermark == 0 || minWatermark > maxWatermark)
+        return false;
+
+    watermarkAdaptive = false;
+
+    if (!setFifoWatermark(minWatermark))
+        return false;
+
+    watermarkMin = minWatermark;
+    watermarkMax = maxWatermark;
+    watermarkMaxFill = maxFill;
+    watermarkOverruns = fifoStats.overruns;
+
+    // Start as if the latency were high, the watermark then climbs as it decays.
+    watermarkOvershootQ4 = (uint32_t)(maxFill / 2) << 4;
+    watermarkAdaptive = true;
+
+    return true;
+}
+
+/// @brief Stops retuning the watermark, it stays at its current value.
+void QwDevLSM6DSV16X::disableAdaptiveWatermark()
+{
+    watermarkAdaptive = false;
+}
+
+/// @brief Returns the watermark last written with setFifoWatermark() or by the
+/// adaptive watermark.
+/// @return The FIFO watermark in words
+uint8_t QwDevLSM6DSV16X::getFifoWatermark()
+{
+    return fifoWatermark;
+}
+
+/// @brief Moves the watermark according to the FIFO level and overruns found at
+/// the last drain, see enableAdaptiveWatermark().
+void QwDevLSM6DSV16X::tuneFifoWatermark()
+{
+    if (!watermarkAdaptive)
+        return;
+
+    uint16_t overshoot = (fifoStats.lastLevel > fifoWatermark) ? fifoStats.lastLevel - fifoWatermark : 0;
+
+    // Peak of the words batched during the drain latency, in 1/16 words,
+    // decaying by 1/16 per drain. Rounding the decay up lets it reach zero.
+    watermarkOvershootQ4 -= (watermarkOvershootQ4 + 15) / 16;
+    if (((uint32_t)overshoot << 4) > watermarkOvershootQ4)
+        watermarkOvershootQ4 = (uint32_t)overshoot << 4;
+
+    if (fifoStats.overruns != watermarkOverruns)
+    {
+        watermarkOverruns = fifoStats.overruns;
+        watermarkOvershootQ4 = (uint32_t)watermarkMaxFill << 4;
+    }
+
+    int32_t target = (int32_t)watermarkMaxFill - 2 * (int32_t)((watermarkOvershootQ4 + 15) >> 4);
+    int32_t upper = watermarkMax;
+
+    if (streamActive && streamCapacity < upper)
+        upper = streamCapacity;
+
+    if (target > upper)
+        target = upper;
+    if (target < watermarkMin)
+        target = watermarkMin;
+
+    // Lower at once, raise in steps of four words or more to spare the bus,
+    // or straight to the upper limit when it is closer.
+    if (target < fifoWatermark || target >= fifoWatermark + 4 || (target == upper && target != fifoWatermark))
+        setFifoWatermark((uint8_t)target);
+}
+
+/// @brief Drains the FIFO into a caller provided array. The FIFO level is read
+/// once, then all available words (up to maxWords) are read in a single burst
+/// instead of one transaction per word.
+/// @param buffer Destination for the tagged FIFO words, packed 7 bytes per word.
+/// @param maxWords The capacity of buffer in words.
+/// @return The number of words read, zero if the FIFO was empty or on error.
+uint16_t QwDevLSM6DSV16X::readFifoBatch(sfe_lsm_fifo_word_t *buffer, uint16_t maxWords)
+{
+    return readFifoBatch(buffer, maxWords, nullptr, 0);
+}
+
+/// @brief Drains the FIFO into two caller provided arrays, e.g. the two free
+/// runs of a ring buffer. The FIFO level is read once, then the first array
+/// is filled before the second, one burst each.
+/// @param first Destination for the first words.
+/// @param firstWords The capacity of first in words.
+/// @param second Destination for the words beyond firstWords.
+/// @param secondWords The capacity of second in words.
+/// @return The number of words read into both, zero if the FIFO was empty or on error.
+uint16_t QwDevLSM6DSV16X::readFifoBatch(sfe_lsm_fifo_word_t *first, uint16_t firstWords, sfe_lsm_fifo_word_t *second,
+                                        uint16_t secondWords)
+{
+    uint16_t numWords;
+
+    fifoReadFailed = true;
+
+    if (!readFifoLevel(&numWords))
+        return 0;
+
+    if (numWords > (uint32_t)firstWords + secondWords)
+        numWords = firstWords + secondWords;
+
+    if (numWords == 0)
+    {
+        fifoReadFailed = false;
+        return 0;
+    }
+
+    uint16_t firstCount = (numWords < firstWords) ? numWords : firstWords;
+
+    if (readRegisterRegion(LSM6DSV16X_FIFO_DATA_OUT_TAG, (uint8_t *)first, firstCount * sizeof(sfe_lsm_fifo_word_t)) !=
+        0)
+        return 0;
+
+    fifoReadFailed = false;
+
+    if (numWords > firstCount &&
+        readRegisterRegion(LSM6DSV16X_FIFO_DATA_OUT_TAG, (uint8_t *)second,
+                           (numWords - firstCount) * sizeof(sfe_lsm_fifo_word_t)) != 0)
+        numWords = firstCount;
+
+    fifoStats.wordsRead += numWords;
+
+    return numWords;
+}
+
+/// @brief Drains the FIFO into the driver's receive buffer, see
+/// getBurstFifoWords(). At most SFE_LSM6DSV16X_RX_BUFFER_SIZE / 7 words are
+/// read per call.
+/// @param maxWords The maximum number of words to read.
+/// @return The number of words read, zero if the FIFO was empty or on error.
+uint16_t QwDevLSM6DSV16X::readFifoBatch(uint16_t maxWords)
+{
+    const uint16_t capacity = sizeof(rxBuffer.fifo) / sizeof(sfe_lsm_fifo_word_t);
+    uint16_t numWords;
+
+    if (!readFifoLevel(&numWords))
+        return 0;
+
+    if (numWords > maxWords)
+        numWords = maxWords;
+    if (numWords > capacity)
+        numWords = capacity;
+
+    if (numWords == 0)
+        return 0;
+
+    if (readBurst(LSM6DSV16X_FIFO_DATA_OUT_TAG, numWords * sizeof(sfe_lsm_fifo_word_t), LSM_BURST_FIFO) != 0)
+        return 0;
+
+    fifoStats.wordsRead += numWords;
+
+    return numWords;
+}
+
+/// @brief Registers a function that processFifo() calls for every FIFO word
+/// of the given type.
+/// @param type The sample type, e.g. LSM_FIFO_ACCEL or LSM_FIFO_GYRO
+/// @param handler The function to call, nullptr removes the handler.
+/// @param context Passed through to the handler unchanged.
+void QwDevLSM6DSV16X::setFifoHandler(sfe_lsm_fifo_type_t type, sfe_lsm_fifo_handler_t handler, void *context)
+{
+    fifoDecoder.setHandler(type, handler, context);
+}
+
+/// @brief Gives access to the FIFO decoder, e.g. to decode words that were
+/// read into a caller buffer with readFifoBatch().
+/// @return The decoder used by processFifo()
+SfeLSMFifoDecoder &QwDevLSM6DSV16X::getFifoDecoder()
+{
+    return fifoDecoder;
+}
+
+/// @brief Logs every change of the FIFO decoder settings made through this
+/// class: full scales, batch rates, the ODR calibration, sensor hub scales and
+/// bypass resets. Start the writer with getFifoDecoder() first, it logs the
+/// settings in effect; the FIFO words themselves are still written by the
+/// caller. Only changes made on the decoder directly need writeConfig().
+/// @param log The writer, nullptr stops logging.
+void QwDevLSM6DSV16X::setFifoLog(SfeLSMFifoLogWriter *log)
+{
+    fifoLog = log;
+}
+
+/// @brief Drains the FIFO through the receive buffer and passes every word to
+/// the registered handlers. The level is read once, the words are then read in
+/// bursts of up to SFE_LSM6DSV16X_RX_BUFFER_SIZE / 7 words.
+/// @param maxWords The maximum number of words to process.
+/// @return The number of words read from the FIFO.
+uint16_t QwDevLSM6DSV16X::processFifo(uint16_t maxWords)
+{
+    const uint16_t capacity = sizeof(rxBuffer.fifo) / sizeof(sfe_lsm_fifo_word_t);
+    uint16_t numRead = 0;
+
+    if (accelScaleSet == false)
+    {
+        getAccelFullScale(&fullScaleAccel);
+        fifoDecoder.setAccelFullScale(fullScaleAccel);
+        accelScaleSet = true;
+    }
+
+    if (gyroScaleSet == false)
+    {
+        getGyroFullScale(&fullScaleGyro);
+        fifoDecoder.setGyroFullScale(fullScaleGyro);
+        gyroScaleSet = true;
+    }
+
+    uint16_t remaining;
+
+    if (!readFifoLevel(&remaining))
+        return 0;
+
+    if (remaining > maxWords)
+        remaining = maxWords;
+
+    while (remaining > 0)
+    {
+        uint16_t numWords = remaining > capacity ? capacity : remaining;
+
+        if (readBurst(LSM6DSV16X_FIFO_DATA_OUT_TAG, numWords * sizeof(sfe_lsm_fifo_word_t), LSM_BURST_FIFO) != 0)
+            break;
+
+        fifoDecoder.decode(rxBuffer.fifo, numWords);
+
+        fifoStats.wordsRead += numWords;
+        numRead += numWords;
+        remaining -= numWords;
+    }
+
+    return numRead;
+}
+
+/// FIFO Streaming//////////////////////////////////////////////////////////////////////////////////
+
+// States of the two streaming buffers.
+#define kStreamFree 0
+#define kStreamReady 1
+#define kStreamHeld 2
+
+/// @brief Routes the FIFO watermark signal to the selected pin. Other signals
+/// already routed to the pin are left as they are.
 /// @param pin the interrupt pin
-/// @param enable enable/disable sleep change interrupt
+/// @param enable enable/disable the FIFO watermark interrupt
 /// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setIntSleepChange(sfe_lsm_pin_t pin, bool enable)
+bool QwDevLSM6DSV16X::setIntFifoWatermark(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.fifo_th = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Starts watermark driven FIFO streaming. The FIFO is emptied, put in
+/// stream mode and its watermark routed to the given pin. Attach an interrupt on
+/// the rising edge of that pin that calls fifoWatermarkISR(), then call
+/// serviceFifoStream() from the main loop. Each service drains the FIFO into
+/// whichever buffer is not in use by the application.
+/// @param bufferA First buffer, bufferWords FIFO words in size.
+/// @param bufferB Second buffer, bufferWords FIFO words in size.
+/// @param bufferWords The capacity of each buffer, at least the watermark.
+/// @param watermark The FIFO level in words that triggers the interrupt.
+/// @param pin The interrupt pin to use.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::beginFifoStream(sfe_lsm_fifo_word_t *bufferA, sfe_lsm_fifo_word_t *bufferB,
+                                      uint16_t bufferWords, uint8_t watermark, sfe_lsm_pin_t pin)
+{
+    if (bufferA == nullptr || bufferB == nullptr || bufferWords < watermark || watermark == 0)
+        return false;
+
+    streamActive = false;
+    streamPending = false;
+
+    streamBuffer[0] = bufferA;
+    streamBuffer[1] = bufferB;
+    streamCapacity = bufferWords;
+    streamState[0] = kStreamFree;
+    streamState[1] = kStreamFree;
+    streamCount[0] = 0;
+    streamCount[1] = 0;
+    streamNextSequence = 0;
+    streamPin = pin;
+
+    if (!setFifoWatermark(watermark))
+        return false;
+
+    if (!setIntFifoWatermark(pin))
+        return false;
+
+    // Start from an empty FIFO
+    if (!setFifoMode(LSM6DSV16X_BYPASS_MODE))
+        return false;
+
+    if (!setFifoMode(LSM6DSV16X_STREAM_MODE))
+        return false;
+
+    streamActive = true;
+
+    return true;
+}
+
+/// @brief Stops FIFO streaming, removes the watermark interrupt and empties the FIFO.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::endFifoStream()
+{
+    streamActive = false;
+    streamPending = false;
+
+    if (!setIntFifoWatermark(streamPin, false))
+        return false;
+
+    return setFifoMode(LSM6DSV16X_BYPASS_MODE);
+}
+
+/// @brief Records that the FIFO reached its watermark, call this from the pin's
+/// interrupt handler. It does not touch the bus.
+void QwDevLSM6DSV16X::fifoWatermarkISR()
+{
+    // Only the first interrupt of a pending drain counts towards the latency.
+    if (!streamPending)
+        streamIrqMicros = micros();
+
+    streamPending = true;
+}
+
+/// @brief Drains the FIFO into a free stream buffer if the watermark interrupt
+/// fired. When both buffers are in use the words stay in the FIFO until one is
+/// released.
+/// @return The number of words drained, zero if nothing was pending.
+uint16_t QwDevLSM6DSV16X::serviceFifoStream()
+{
+    if (!streamActive || !streamPending)
+        return 0;
+
+    uint8_t index;
+
+    if (streamState[0] == kStreamFree)
+        index = 0;
+    else if (streamState[1] == kStreamFree)
+        index = 1;
+    else
+        return 0;
+
+    // Cleared before the read so that an interrupt during the drain is kept.
+    uint32_t irqMicros = streamIrqMicros;
+    uint32_t latency = micros() - irqMicros;
+    streamPending = false;
+
+    uint16_t numWords = readFifoBatch(streamBuffer[index], streamCapacity);
+
+    // The FIFO is still above the watermark, so the pin stays active and no
+    // new edge will come: try again on the next service.
+    if (fifoReadFailed)
+    {
+        streamIrqMicros = irqMicros;
+        streamPending = true;
+        return 0;
+    }
+
+    fifoStats.lastLatencyUs = latency;
+    fifoStats.totalLatencyUs += latency;
+    fifoStats.latencyCount++;
+    if (latency > fifoStats.maxLatencyUs)
+        fifoStats.maxLatencyUs = latency;
+
+    tuneFifoWatermark();
+
+    // A full buffer may have left words behind, the watermark will not rise
+    // again for those so pick them up on the next service.
+    if (numWords == streamCapacity)
+    {
+        streamIrqMicros = micros();
+        streamPending = true;
+    }
+
+    if (numWords == 0)
+        return 0;
+
+    streamCount[index] = numWords;
+    streamSequence[index] = streamNextSequence++;
+    streamState[index] = kStreamReady;
+
+    return numWords;
+}
+
+/// @brief Hands the oldest filled stream buffer to the application. It stays
+/// untouched by serviceFifoStream() until it is released.
+/// @param count Set to the number of FIFO words in the buffer.
+/// @return The buffer, or nullptr if none is ready.
+const sfe_lsm_fifo_word_t *QwDevLSM6DSV16X::getFifoStreamBuffer(uint16_t *count)
+{
+    int8_t index = -1;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (streamState[i] != kStreamReady)
+            continue;
+
+        if (index < 0 || (int32_t)(streamSequence[i] - streamSequence[index]) < 0)
+            index = i;
+    }
+
+    if (index < 0)
+    {
+        *count = 0;
+        return nullptr;
+    }
+
+    streamState[index] = kStreamHeld;
+    *count = streamCount[index];
+
+    return streamBuffer[index];
+}
+
+/// @brief Returns a buffer obtained with getFifoStreamBuffer() so it can be filled again.
+/// @param buffer The buffer to release.
+void QwDevLSM6DSV16X::releaseFifoStreamBuffer(const sfe_lsm_fifo_word_t *buffer)
+{
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        if (streamBuffer[i] == buffer && streamState[i] == kStreamHeld)
+            streamState[i] = kStreamFree;
+    }
+}
+
+/// FIFO Frames//////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Sets the batch counter, which raises its flag and interrupt every
+/// time the trigger sensor has batched the given number of samples.
+/// @param threshold Batch events between interrupts, 1 - 1023
+/// @param trigger The sensor whose batch events are counted:
+///		LSM6DSV16X_XL_BATCH_EVENT
+///		LSM6DSV16X_GY_BATCH_EVENT
+///		LSM6DSV16X_GY_EIS_BATCH_EVENT
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setFifoBatchCounter(uint16_t threshold, lsm6dsv16x_fifo_batch_cnt_event_t trigger)
+{
+    int32_t retVal;
+
+    if (threshold == 0 || threshold > 1023)
+        return false;
+
+    retVal = lsm6dsv16x_fifo_batch_cnt_event_set(&sfe_dev, trigger);
+
+    if (retVal != 0)
+        return false;
+
+    retVal = lsm6dsv16x_fifo_batch_counter_threshold_set(&sfe_dev, threshold);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Routes the batch counter interrupt to the selected pin.
+/// @param pin The interrupt pin
+/// @param enable Enable/disable the batch counter interrupt
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setIntFifoBatchCounter(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.cnt_bdr = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Starts frame capture: the FIFO streams and the batch counter
+/// interrupts on the given pin each time frameSamples samples of the trigger
+/// sensor have been batched. Attach an interrupt on the rising edge of that pin
+/// that calls fifoFrameISR(), then call readFifoFrame() from the main loop.
+/// @param buffer Holds one frame plus the words batched while it is read, so
+/// make it larger than the FIFO words of one frame, e.g. twice as large.
+/// @param bufferWords The capacity of the buffer in FIFO words.
+/// @param frameSamples Samples of the trigger sensor per frame, 1 - 1023
+/// @param pin The interrupt pin to use.
+/// @param trigger The sensor the frame is counted in, see setFifoBatchCounter()
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::beginFifoFrames(sfe_lsm_fifo_word_t *buffer, uint16_t bufferWords, uint16_t frameSamples,
+                                      sfe_lsm_pin_t pin, lsm6dsv16x_fifo_batch_cnt_event_t trigger)
+{
+    if (buffer == nullptr || bufferWords < frameSamples)
+        return false;
+
+    frameActive = false;
+    framePending = false;
+
+    frameBuffer = buffer;
+    frameCapacity = bufferWords;
+    this->frameSamples = frameSamples;
+    frameTrigger = trigger;
+    frameWords = 0;
+    frameLength = 0;
+    framePin = pin;
+
+    if (!setFifoBatchCounter(frameSamples, trigger))
+        return false;
+
+    if (!setIntFifoBatchCounter(pin))
+        return false;
+
+    // Start from an empty FIFO so the first frame starts with the first sample
+    if (!setFifoMode(LSM6DSV16X_BYPASS_MODE))
+        return false;
+
+    if (!setFifoMode(LSM6DSV16X_STREAM_MODE))
+        return false;
+
+    frameActive = true;
+
+    return true;
+}
+
+/// @brief Stops frame capture, removes the batch counter interrupt and empties the FIFO.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::endFifoFrames()
+{
+    frameActive = false;
+    framePending = false;
+
+    if (!setIntFifoBatchCounter(framePin, false))
+        return false;
+
+    return setFifoMode(LSM6DSV16X_BYPASS_MODE);
+}
+
+/// @brief Records that a frame is complete, call this from the pin's interrupt
+/// handler. It does not touch the bus.
+void QwDevLSM6DSV16X::fifoFrameISR()
+{
+    if (!framePending)
+        frameIrqMicros = micros();
+
+    framePending = true;
+}
+
+/// @brief Returns the number of trigger sensor samples a FIFO word carries.
+/// @param tag The word's tag byte.
+/// @param trigger The batch counter trigger, lsm6dsv16x_fifo_batch_cnt_event_t
+/// @return 0 - 3
+static uint8_t frameSamplesInWord(uint8_t tag, uint8_t trigger)
+{
+    uint8_t sensor = tag >> 3;
+
+    // Uncompressed, two and three sample words of the accelerometer and the gyroscope
+    static const uint8_t accelSamples[14] = {0, 0, 1, 0, 0, 0, 1, 1, 2, 3, 0, 0, 0, 0};
+    static const uint8_t gyroSamples[14] = {0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 3};
+
+    if (trigger == LSM6DSV16X_GY_EIS_BATCH_EVENT)
+        return (sensor == 0x1E) ? 1 : 0;
+
+    if (sensor >= 14)
+        return 0;
+
+    return (trigger == LSM6DSV16X_GY_BATCH_EVENT) ? gyroSamples[sensor] : accelSamples[sensor];
+}
+
+/// @brief Hands out the next complete frame, reading the FIFO in one burst if
+/// the batch counter interrupt fired. A frame runs up to and including the word
+/// that completes frameSamples samples of the trigger sensor and holds all words
+/// of other sensors batched in between. With FIFO compression a frame can end
+/// up to two samples late, as a compressed word is not split. The frame stays
+/// valid until the next call.
+/// @param count Set to the number of FIFO words in the frame.
+/// @return The frame, or nullptr if no complete frame is available.
+const sfe_lsm_fifo_word_t *QwDevLSM6DSV16X::readFifoFrame(uint16_t *count)
+{
+    *count = 0;
+
+    if (!frameActive)
+        return nullptr;
+
+    // Drop the frame handed out last, the words read beyond it move to the front.
+    if (frameLength > 0)
+    {
+        frameWords -= frameLength;
+        memmove(frameBuffer, frameBuffer + frameLength, frameWords * sizeof(sfe_lsm_fifo_word_t));
+        frameLength = 0;
+    }
+
+    for (uint8_t pass = 0; pass < 2; pass++)
+    {
+        uint16_t samples = 0;
+
+        for (uint16_t i = 0; i < frameWords; i++)
+        {
+            samples += frameSamplesInWord(frameBuffer[i].tag, frameTrigger);
+
+            if (samples >= frameSamples)
+            {
+                frameLength = i + 1;
+                *count = frameLength;
+                return frameBuffer;
+            }
+        }
+
+        if (pass > 0 || !framePending)
+            break;
+
+        uint32_t latency = micros() - frameIrqMicros;
+        framePending = false;
+
+        fifoStats.lastLatencyUs = latency;
+        fifoStats.totalLatencyUs += latency;
+        fifoStats.latencyCount++;
+        if (latency > fifoStats.maxLatencyUs)
+            fifoStats.maxLatencyUs = latency;
+
+        // Without room for the rest of a frame the words held are useless.
+        if (frameWords == frameCapacity)
+            frameWords = 0;
+
+        frameWords += readFifoBatch(frameBuffer + frameWords, frameCapacity - frameWords);
+    }
+
+    return nullptr;
+}
+
+/// FIFO Capture//////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Arms a capture of the FIFO words around an interrupt event, e.g. an
+/// impact detected by the wake-up function. Configure the event's detector
+/// first, this only routes it. The pin interrupts at the event, and once the
+/// window is complete if postWords follow the event. Call
+/// fifoCaptureISR() from the pin's interrupt handler and serviceFifoCapture()
+/// after every interrupt, the MCU can sleep in between.
+///
+/// With only postWords the FIFO runs in bypass-to-FIFO mode and with only
+/// preWords in stream-to-FIFO mode, both stopping at the watermark, so the
+/// device freezes the window itself at the event. A split window streams the
+/// last preWords words until serviceFifoCapture() sees the event, then switches
+/// to FIFO mode. The event then lies that many words later in the window as the
+/// service was late, the window stays gapless.
+/// @param event The interrupt event that ends the capture.
+/// @param preWords FIFO words kept from before the event.
+/// @param postWords FIFO words collected after the event, preWords + postWords <= 255
+/// @param pin The interrupt pin to use.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::armFifoCapture(sfe_lsm_capture_event_t event, uint8_t preWords, uint8_t postWords,
+                                     sfe_lsm_pin_t pin)
+{
+    int32_t retVal;
+    lsm6dsv16x_fifo_mode_t mode;
+
+    if ((uint16_t)preWords + postWords == 0 || (uint16_t)preWords + postWords > 255)
+        return false;
+
+    if (captureState != LSM_CAPTURE_IDLE && !disarmFifoCapture())
+        return false;
+
+    captureEvent = event;
+    capturePre = preWords;
+    capturePost = postWords;
+    capturePin = pin;
+    capturePending = false;
+
+    if (postWords == 0)
+        mode = LSM6DSV16X_STREAM_TO_FIFO_MODE;
+    else if (preWords == 0)
+        mode = LSM6DSV16X_BYPASS_TO_FIFO_MODE;
+    else
+        mode = LSM6DSV16X_STREAM_MODE;
+
+    // The watermark limits the FIFO depth, in stream mode too.
+    retVal = lsm6dsv16x_fifo_stop_on_wtm_set(&sfe_dev, 1);
+
+    if (retVal != 0)
+        return false;
+
+    if (!setFifoWatermark(preWords > 0 ? preWords : postWords))
+        return false;
+
+    if (!setFifoMode(LSM6DSV16X_BYPASS_MODE))
+        return false;
+
+    // The routed event is what triggers the FIFO mode change. A post-event
+    // only window is complete at the watermark, all others are woken by the
+    // event.
+    if (!setCaptureRoute(true, preWords == 0))
+        return false;
+
+    if (!setFifoMode(mode))
+        return false;
+
+    captureState = LSM_CAPTURE_ARMED;
+
+    return true;
+}
+
+/// @brief Cancels a capture, removes its interrupts and empties the FIFO.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::disarmFifoCapture()
+{
+    int32_t retVal;
+
+    captureState = LSM_CAPTURE_IDLE;
+    capturePending = false;
+
+    if (!setCaptureRoute(false, false))
+        return false;
+
+    retVal = lsm6dsv16x_fifo_stop_on_wtm_set(&sfe_dev, 0);
+
+    if (retVal != 0)
+        return false;
+
+    return setFifoMode(LSM6DSV16X_BYPASS_MODE);
+}
+
+/// @brief Records the capture interrupt, call this from the pin's interrupt
+/// handler. It does not touch the bus.
+void QwDevLSM6DSV16X::fifoCaptureISR()
+{
+    capturePending = true;
+}
+
+/// @brief Moves the capture on after an interrupt. For a split window this
+/// switches the FIFO from stream to FIFO mode at the event, for a post-event
+/// only window it reads the FIFO status to tell the event from the watermark.
+/// @return The capture state, LSM_CAPTURE_DONE once the window can be read.
+sfe_lsm_capture_state_t QwDevLSM6DSV16X::serviceFifoCapture()
+{
+    if (!capturePending)
+        return captureState;
+
+    capturePending = false;
+
+    // A post-event only window shares the pin between the event and the
+    // watermark, only the watermark ends it.
+    if (capturePre == 0 && (captureState == LSM_CAPTURE_ARMED || captureState == LSM_CAPTURE_POST))
+    {
+        lsm6dsv16x_fifo_status_t status;
+
+        if (!getFifoStatus(&status))
+        {
+            capturePending = true;
+            return captureState;
+        }
+
+        captureState = status.fifo_th ? LSM_CAPTURE_DONE : LSM_CAPTURE_POST;
+
+        return captureState;
+    }
+
+    if (captureState == LSM_CAPTURE_ARMED)
+    {
+        if (capturePost == 0)
+        {
+            captureState = LSM_CAPTURE_DONE;
+            return captureState;
+        }
+
+        // Keep the words in the FIFO and let it fill up to the whole window,
+        // the watermark interrupt then marks the end.
+        if (!setFifoWatermark(capturePre + capturePost) || !setFifoMode(LSM6DSV16X_FIFO_MODE) ||
+            !setCaptureRoute(false, true))
+            return captureState;
+
+        captureState = LSM_CAPTURE_POST;
+    }
+    else if (captureState == LSM_CAPTURE_POST)
+    {
+        captureState = LSM_CAPTURE_DONE;
+    }
+
+    return captureState;
+}
+
+/// @brief Reads the captured window in one drain and ends the capture, arm it
+/// again for the next event. The FIFO stays in its frozen mode until then, call
+/// disarmFifoCapture() to return to normal FIFO use.
+/// @param buffer Receives the FIFO words, oldest first.
+/// @param maxWords The capacity of the buffer, preWords + postWords fits all.
+/// @return The number of words read, zero if the capture is not done or the
+/// capture interrupts could not be removed. The window stays in the FIFO then
+/// and the call can be repeated.
+uint16_t QwDevLSM6DSV16X::readFifoCapture(sfe_lsm_fifo_word_t *buffer, uint16_t maxWords)
+{
+    if (captureState != LSM_CAPTURE_DONE)
+        return 0;
+
+    // The FIFO is frozen, so the interrupts can go before the drain.
+    if (!setCaptureRoute(false, false))
+        return 0;
+
+    uint16_t numWords = readFifoBatch(buffer, maxWords);
+
+    captureState = LSM_CAPTURE_IDLE;
+
+    return numWords;
+}
+
+/// @brief Routes the capture event and the FIFO watermark to the capture pin,
+/// leaving the pin's other interrupts as they are.
+/// @param event Enable/disable the capture event interrupt
+/// @param watermark Enable/disable the FIFO watermark interrupt
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setCaptureRoute(bool event, bool watermark)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, capturePin))
+        return false;
+
+    switch (captureEvent)
+    {
+    case LSM_CAPTURE_WAKEUP:
+        int_route.wakeup = (uint8_t)event;
+        break;
+    case LSM_CAPTURE_FREE_FALL:
+        int_route.freefall = (uint8_t)event;
+        break;
+    case LSM_CAPTURE_SINGLE_TAP:
+        int_route.single_tap = (uint8_t)event;
+        break;
+    case LSM_CAPTURE_DOUBLE_TAP:
+        int_route.double_tap = (uint8_t)event;
+        break;
+    case LSM_CAPTURE_EMB_FUNC:
+        int_route.emb_func = (uint8_t)event;
+        break;
+    }
+
+    int_route.fifo_th = (uint8_t)watermark;
+
+    return setIntRoute(int_route, capturePin);
+}
+
+////Interrupt Settings//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Retrieves all interrupt source bits. Takes a handful of bus
+/// transactions and two bank switches, see getEnabledInterrupts() for a
+/// cheaper read from an interrupt handler.
+/// @param source interrupt bits
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::getAllInterrupts(lsm6dsv16x_all_sources_t *source)
+{
+    return getInterrupts(source, LSM_INT_ALL);
+}
+
+/// @brief Retrieves the interrupt source bits of the given register groups,
+/// one burst read per group. Bits of groups not read are left zero. With
+/// latched interrupts, reading a group acknowledges the sources in it.
+/// @param source interrupt bits
+/// @param groups The groups to read, sfe_lsm_int_group_t values OR'd together
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::getInterrupts(lsm6dsv16x_all_sources_t *source, uint8_t groups)
+{
+    int32_t retVal = 0;
+    uint8_t buff[8];
+
+    memset(source, 0, sizeof(*source));
+
+    // The source registers go first: reading ALL_INT_SRC resets every latched
+    // source, which would otherwise take a FUNCTIONS_ENABLE write to prevent.
+    if (groups & (LSM_INT_EVENTS | LSM_INT_EMB_STATUS))
+    {
+        lsm6dsv16x_ui_status_reg_ois_t status_reg_ois;
+        lsm6dsv16x_wake_up_src_t wake_up_src;
+        lsm6dsv16x_tap_src_t tap_src;
+        lsm6dsv16x_d6d_src_t d6d_src;
+        lsm6dsv16x_status_master_t status_shub;
+        lsm6dsv16x_emb_func_status_mainpage_t emb_func_status_mainpage;
+        lsm6dsv16x_fsm_status_mainpage_t fsm_status_mainpage;
+        lsm6dsv16x_mlc_status_mainpage_t mlc_status_mainpage;
+
+        // UI_STATUS_REG_OIS to D6D_SRC, STATUS_MASTER_MAINPAGE to MLC_STATUS_MAINPAGE, or both
+        uint8_t first = (groups & LSM_INT_EVENTS) ? 0 : 4;
+        uint8_t last = (groups & LSM_INT_EMB_STATUS) ? 7 : 3;
+
+        retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_UI_STATUS_REG_OIS + first, &buff[first], last - first + 1);
+        if (retVal != 0)
+            return false;
+
+        if (groups & LSM_INT_EVENTS)
+        {
+            memcpy(&status_reg_ois, &buff[0], 1);
+            memcpy(&wake_up_src, &buff[1], 1);
+            memcpy(&tap_src, &buff[2], 1);
+            memcpy(&d6d_src, &buff[3], 1);
+
+            source->gy_settling = status_reg_ois.gyro_settling;
+
+            source->free_fall = wake_up_src.ff_ia;
+            source->wake_up = wake_up_src.wu_ia;
+            source->wake_up_x = wake_up_src.x_wu;
+            source->wake_up_y = wake_up_src.y_wu;
+            source->wake_up_z = wake_up_src.z_wu;
+            source->sleep_change = wake_up_src.sleep_change_ia;
+            source->sleep_state = wake_up_src.sleep_state;
+
+            source->tap_x = tap_src.x_tap;
+            source->tap_y = tap_src.y_tap;
+            source->tap_z = tap_src.z_tap;
+            source->tap_sign = tap_src.tap_sign;
+            source->double_tap = tap_src.double_tap;
+            source->single_tap = tap_src.single_tap;
+
+            source->six_d = d6d_src.d6d_ia;
+            source->six_d_xl = d6d_src.xl;
+            source->six_d_xh = d6d_src.xh;
+            source->six_d_yl = d6d_src.yl;
+            source->six_d_yh = d6d_src.yh;
+            source->six_d_zl = d6d_src.zl;
+            source->six_d_zh = d6d_src.zh;
+        }
+
+        if (groups & LSM_INT_EMB_STATUS)
+        {
+            memcpy(&status_shub, &buff[4], 1);
+            memcpy(&emb_func_status_mainpage, &buff[5], 1);
+            memcpy(&fsm_status_mainpage, &buff[6], 1);
+            memcpy(&mlc_status_mainpage, &buff[7], 1);
+
+            source->sh_endop = status_shub.sens_hub_endop;
+            source->sh_wr_once = status_shub.wr_once_done;
+            source->sh_slave0_nack = status_shub.slave0_nack;
+            source->sh_slave1_nack = status_shub.slave1_nack;
+            source->sh_slave2_nack = status_shub.slave2_nack;
+            source->sh_slave3_nack = status_shub.slave3_nack;
+
+            source->step_detector = emb_func_status_mainpage.is_step_det;
+            source->tilt = emb_func_status_mainpage.is_tilt;
+            source->sig_mot = emb_func_status_mainpage.is_sigmot;
+            source->fsm_lc = emb_func_status_mainpage.is_fsm_lc;
+
+            source->fsm1 = fsm_status_mainpage.is_fsm1;
+            source->fsm2 = fsm_status_mainpage.is_fsm2;
+            source->fsm3 = fsm_status_mainpage.is_fsm3;
+            source->fsm4 = fsm_status_mainpage.is_fsm4;
+            source->fsm5 = fsm_status_mainpage.is_fsm5;
+            source->fsm6 = fsm_status_mainpage.is_fsm6;
+            source->fsm7 = fsm_status_mainpage.is_fsm7;
+            source->fsm8 = fsm_status_mainpage.is_fsm8;
+
+            source->mlc1 = mlc_status_mainpage.is_mlc1;
+            source->mlc2 = mlc_status_mainpage.is_mlc2;
+            source->mlc3 = mlc_status_mainpage.is_mlc3;
+            source->mlc4 = mlc_status_mainpage.is_mlc4;
+        }
+    }
+
+    if (groups & LSM_INT_EMB_BANK)
+    {
+        lsm6dsv16x_emb_func_exec_status_t emb_func_exec_status;
+        lsm6dsv16x_emb_func_src_t emb_func_src;
+
+        retVal = lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_EMBED_FUNC_MEM_BANK);
+        if (retVal == 0)
+            retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_EMB_FUNC_EXEC_STATUS, (uint8_t *)&emb_func_exec_status, 1);
+        if (retVal == 0)
+            retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_EMB_FUNC_SRC, (uint8_t *)&emb_func_src, 1);
+        retVal += lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_MAIN_MEM_BANK);
+
+        if (retVal != 0)
+            return false;
+
+        source->emb_func_stand_by = emb_func_exec_status.emb_func_endop;
+        source->emb_func_time_exceed = emb_func_exec_status.emb_func_exec_ovr;
+        source->step_count_inc = emb_func_src.stepcounter_bit_set;
+        source->step_count_overflow = emb_func_src.step_overflow;
+        source->step_on_delta_time = emb_func_src.step_count_delta_ia;
+        source->step_detector |= emb_func_src.step_detected;
+    }
+
+    if (groups & LSM_INT_STATUS)
+    {
+        lsm6dsv16x_fifo_status2_t fifo_status2;
+        lsm6dsv16x_all_int_src_t all_int_src;
+        lsm6dsv16x_status_reg_t status_reg;
+
+        // FIFO_STATUS1 to STATUS_REG
+        retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_FIFO_STATUS1, buff, 4);
+        if (retVal != 0)
+            return false;
+
+        memcpy(&fifo_status2, &buff[1], 1);
+        memcpy(&all_int_src, &buff[2], 1);
+        memcpy(&status_reg, &buff[3], 1);
+
+        source->fifo_ovr = fifo_status2.fifo_ovr_ia;
+        source->fifo_bdr = fifo_status2.counter_bdr_ia;
+        source->fifo_full = fifo_status2.fifo_full_ia;
+        source->fifo_th = fifo_status2.fifo_wtm_ia;
+
+        // Combined with the event sources, which may have been acknowledged above.
+        source->free_fall |= all_int_src.ff_ia;
+        source->wake_up |= all_int_src.wu_ia;
+        source->six_d |= all_int_src.d6d_ia;
+        source->sleep_change |= all_int_src.sleep_change_ia;
+
+        source->drdy_xl = status_reg.xlda;
+        source->drdy_gy = status_reg.gda;
+        source->drdy_temp = status_reg.tda;
+        source->drdy_ah_qvar = status_reg.ah_qvarda;
+        source->drdy_eis = status_reg.gda_eis;
+        source->drdy_ois = status_reg.ois_drdy;
+        source->timestamp = status_reg.timestamp_endcount;
+    }
+
+    return true;
+}
+
+/// @brief Retrieves the interrupt source bits of the signals routed to either
+/// interrupt pin, reading only the register groups that hold them. Takes one
+/// bus transaction for data ready and FIFO interrupts, two when events such as
+/// tap or wake-up are routed as well.
+/// @param source interrupt bits
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::getEnabledInterrupts(lsm6dsv16x_all_sources_t *source)
+{
+    return getInterrupts(source, getEnabledInterruptGroups());
+}
+
+/// @brief Returns the register groups getEnabledInterrupts() reads, following
+/// the signals routed with setIntRoute() and the functions built on it.
+/// @return sfe_lsm_int_group_t values OR'd together, LSM_INT_STATUS if nothing is routed
+uint8_t QwDevLSM6DSV16X::getEnabledInterruptGroups()
+{
+    uint8_t groups = 0;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        const lsm6dsv16x_pin_int_route_t &route = intRoute[i];
+
+        if (route.drdy_xl || route.drdy_g || route.drdy_g_eis || route.fifo_th || route.fifo_ovr ||
+            route.fifo_full || route.cnt_bdr || route.timestamp)
+            groups |= LSM_INT_STATUS;
+        if (route.single_tap || route.double_tap || route.wakeup || route.freefall || route.sleep_change ||
+            route.sixd)
+            groups |= LSM_INT_EVENTS;
+        if (route.shub || route.emb_func)
+            groups |= LSM_INT_EMB_STATUS;
+        if (route.emb_func_endop)
+            groups |= LSM_INT_EMB_BANK;
+    }
+
+    if (groups == 0)
+        groups = LSM_INT_STATUS;
+
+    return groups;
+}
+
+/// @brief Sets the active state of the interrupt pin - high or low.
+/// @param activeLow Enable/disable active low interrupts
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setInt2DENActiveLow(bool activeLow)
+{
+    int32_t retVal = 0;
+
+    // 0 = active high :  active low, 1
+    retVal = lsm6dsv16x_den_polarity_set(&sfe_dev, (lsm6dsv16x_den_polarity_t)activeLow);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Selects the signal that will be routed to the selected interrupt.
+/// @param val The interrupt to route.
+/// @param pin The pin to route to.
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntRoute(lsm6dsv16x_pin_int_route_t val, sfe_lsm_pin_t pin)
+{
+    int32_t retVal = 0;
+
+    if (pin == LSM_PIN_ONE)
+        retVal = lsm6dsv16x_pin_int1_route_set(&sfe_dev, &val);
+    if (pin == LSM_PIN_TWO)
+        retVal = lsm6dsv16x_pin_int2_route_set(&sfe_dev, &val);
+
+    if (retVal != 0)
+        return false;
+
+    if (pin == LSM_PIN_ONE || pin == LSM_PIN_TWO)
+        intRoute[pin - LSM_PIN_ONE] = val;
+
+    return true;
+}
+
+/// @brief Reads the signals routed to the selected interrupt.
+/// @param val The signals routed to the pin.
+/// @param pin The pin to read.
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getIntRoute(lsm6dsv16x_pin_int_route_t *val, sfe_lsm_pin_t pin)
+{
+    int32_t retVal = -1;
+
+    if (pin == LSM_PIN_ONE)
+        retVal = lsm6dsv16x_pin_int1_route_get(&sfe_dev, val);
+    if (pin == LSM_PIN_TWO)
+        retVal = lsm6dsv16x_pin_int2_route_get(&sfe_dev, val);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+// Packs a routing plan into INT1_CTRL, INT2_CTRL and MD1_CFG, MD2_CFG, in that
+// order. Bits that are not used are zero.
+static void packIntRoutePlan(const sfe_lsm_int_plan_t &plan, uint8_t ctrl[2], uint8_t cfg[2])
+{
+    lsm6dsv16x_int1_ctrl_t int1_ctrl = {};
+    lsm6dsv16x_int2_ctrl_t int2_ctrl = {};
+    lsm6dsv16x_md1_cfg_t md1_cfg = {};
+    lsm6dsv16x_md2_cfg_t md2_cfg = {};
+
+    int1_ctrl.int1_drdy_xl = plan.int1.drdy_xl;
+    int1_ctrl.int1_drdy_g = plan.int1.drdy_g;
+    int1_ctrl.int1_fifo_th = plan.int1.fifo_th;
+    int1_ctrl.int1_fifo_ovr = plan.int1.fifo_ovr;
+    int1_ctrl.int1_fifo_full = plan.int1.fifo_full;
+    int1_ctrl.int1_cnt_bdr = plan.int1.cnt_bdr;
+
+    int2_ctrl.int2_drdy_xl = plan.int2.drdy_xl;
+    int2_ctrl.int2_drdy_g = plan.int2.drdy_g;
+    int2_ctrl.int2_drdy_g_eis = plan.int2.drdy_g_eis;
+    int2_ctrl.int2_fifo_th = plan.int2.fifo_th;
+    int2_ctrl.int2_fifo_ovr = plan.int2.fifo_ovr;
+    int2_ctrl.int2_fifo_full = plan.int2.fifo_full;
+    int2_ctrl.int2_cnt_bdr = plan.int2.cnt_bdr;
+    int2_ctrl.int2_emb_func_endop = plan.int2.emb_func_endop;
+
+    md1_cfg.int1_shub = plan.int1.shub;
+    md1_cfg.int1_emb_func = plan.int1.emb_func;
+    md1_cfg.int1_6d = plan.int1.sixd;
+    md1_cfg.int1_double_tap = plan.int1.double_tap;
+    md1_cfg.int1_ff = plan.int1.freefall;
+    md1_cfg.int1_wu = plan.int1.wakeup;
+    md1_cfg.int1_single_tap = plan.int1.single_tap;
+    md1_cfg.int1_sleep_change = plan.int1.sleep_change;
+
+    md2_cfg.int2_timestamp = plan.int2.timestamp;
+    md2_cfg.int2_emb_func = plan.int2.emb_func;
+    md2_cfg.int2_6d = plan.int2.sixd;
+    md2_cfg.int2_double_tap = plan.int2.double_tap;
+    md2_cfg.int2_ff = plan.int2.freefall;
+    md2_cfg.int2_wu = plan.int2.wakeup;
+    md2_cfg.int2_single_tap = plan.int2.single_tap;
+    md2_cfg.int2_sleep_change = plan.int2.sleep_change;
+
+    memcpy(&ctrl[0], &int1_ctrl, 1);
+    memcpy(&ctrl[1], &int2_ctrl, 1);
+    memcpy(&cfg[0], &md1_cfg, 1);
+    memcpy(&cfg[1], &md2_cfg, 1);
+}
+
+// The inverse of packIntRoutePlan().
+static void unpackIntRoutePlan(const uint8_t ctrl[2], const uint8_t cfg[2], sfe_lsm_int_plan_t *plan)
+{
+    lsm6dsv16x_int1_ctrl_t int1_ctrl;
+    lsm6dsv16x_int2_ctrl_t int2_ctrl;
+    lsm6dsv16x_md1_cfg_t md1_cfg;
+    lsm6dsv16x_md2_cfg_t md2_cfg;
+
+    memcpy(&int1_ctrl, &ctrl[0], 1);
+    memcpy(&int2_ctrl, &ctrl[1], 1);
+    memcpy(&md1_cfg, &cfg[0], 1);
+    memcpy(&md2_cfg, &cfg[1], 1);
+
+    plan->int1 = {};
+    plan->int2 = {};
+
+    plan->int1.drdy_xl = int1_ctrl.int1_drdy_xl;
+    plan->int1.drdy_g = int1_ctrl.int1_drdy_g;
+    plan->int1.fifo_th = int1_ctrl.int1_fifo_th;
+    plan->int1.fifo_ovr = int1_ctrl.int1_fifo_ovr;
+    plan->int1.fifo_full = int1_ctrl.int1_fifo_full;
+    plan->int1.cnt_bdr = int1_ctrl.int1_cnt_bdr;
+
+    plan->int2.drdy_xl = int2_ctrl.int2_drdy_xl;
+    plan->int2.drdy_g = int2_ctrl.int2_drdy_g;
+    plan->int2.drdy_g_eis = int2_ctrl.int2_drdy_g_eis;
+    plan->int2.fifo_th = int2_ctrl.int2_fifo_th;
+    plan->int2.fifo_ovr = int2_ctrl.int2_fifo_ovr;
+    plan->int2.fifo_full = int2_ctrl.int2_fifo_full;
+    plan->int2.cnt_bdr = int2_ctrl.int2_cnt_bdr;
+    plan->int2.emb_func_endop = int2_ctrl.int2_emb_func_endop;
+
+    plan->int1.shub = md1_cfg.int1_shub;
+    plan->int1.emb_func = md1_cfg.int1_emb_func;
+    plan->int1.sixd = md1_cfg.int1_6d;
+    plan->int1.double_tap = md1_cfg.int1_double_tap;
+    plan->int1.freefall = md1_cfg.int1_ff;
+    plan->int1.wakeup = md1_cfg.int1_wu;
+    plan->int1.single_tap = md1_cfg.int1_single_tap;
+    plan->int1.sleep_change = md1_cfg.int1_sleep_change;
+
+    plan->int2.timestamp = md2_cfg.int2_timestamp;
+    plan->int2.emb_func = md2_cfg.int2_emb_func;
+    plan->int2.sixd = md2_cfg.int2_6d;
+    plan->int2.double_tap = md2_cfg.int2_double_tap;
+    plan->int2.freefall = md2_cfg.int2_ff;
+    plan->int2.wakeup = md2_cfg.int2_wu;
+    plan->int2.single_tap = md2_cfg.int2_single_tap;
+    plan->int2.sleep_change = md2_cfg.int2_sleep_change;
+}
+
+/// @brief Routes the signals for both interrupt pins at once. INT1_CTRL and
+/// INT2_CTRL are written in one burst, MD1_CFG and MD2_CFG in another, and
+/// both pairs are read back and compared with the plan: four transactions in
+/// total, where routing signal by signal takes four per signal. Signals not
+/// set in the plan are taken off their pin.
+/// @param plan The signals to route to each pin.
+/// @return True if the device holds the plan, false if the plan asks for a
+/// signal the pin cannot carry (drdy_g_eis, emb_func_endop and timestamp are
+/// INT2 only, shub is INT1 only), on a bus error or if the read back differs.
+bool QwDevLSM6DSV16X::setIntRoutePlan(const sfe_lsm_int_plan_t &plan)
+{
+    if (plan.int1.drdy_g_eis || plan.int1.emb_func_endop || plan.int1.timestamp || plan.int2.shub)
+        return false;
+
+    uint8_t ctrl[2];
+    uint8_t cfg[2];
+
+    packIntRoutePlan(plan, ctrl, cfg);
+
+    if (writeRegisterRegion(LSM6DSV16X_INT1_CTRL, ctrl, 2) != 0)
+        return false;
+
+    if (writeRegisterRegion(LSM6DSV16X_MD1_CFG, cfg, 2) != 0)
+        return false;
+
+    uint8_t ctrlRead[2];
+    uint8_t cfgRead[2];
+
+    if (readRegisterRegion(LSM6DSV16X_INT1_CTRL, ctrlRead, 2) != 0)
+        return false;
+
+    if (readRegisterRegion(LSM6DSV16X_MD1_CFG, cfgRead, 2) != 0)
+        return false;
+
+    // Cache what the device holds, which is what the read back says even if it
+    // differs from the plan.
+    sfe_lsm_int_plan_t held;
+
+    unpackIntRoutePlan(ctrlRead, cfgRead, &held);
+    intRoute[0] = held.int1;
+    intRoute[1] = held.int2;
+
+    if (memcmp(ctrl, ctrlRead, 2) != 0 || memcmp(cfg, cfgRead, 2) != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Reads the signals routed to both interrupt pins, in two transactions.
+/// @param plan Filled with the signals routed to each pin.
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getIntRoutePlan(sfe_lsm_int_plan_t *plan)
+{
+    uint8_t ctrl[2];
+    uint8_t cfg[2];
+
+    if (readRegisterRegion(LSM6DSV16X_INT1_CTRL, ctrl, 2) != 0)
+        return false;
+
+    if (readRegisterRegion(LSM6DSV16X_MD1_CFG, cfg, 2) != 0)
+        return false;
+
+    unpackIntRoutePlan(ctrl, cfg, plan);
+
+    return true;
+}
+
+/// @brief Routes the data ready signal for the accelerometer to the selected pin.
+/// @param pin the interrupt pin
+/// @param enable enable/disable accelerometer data ready interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntAccelDataReady(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.drdy_xl = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Routes the data ready signal for the Gyroscope to the selected pin.
+/// @param pin the interrupt pin
+/// @param enable enable/disable gyroscope data ready interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntGyroDataReady(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.drdy_g = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Enables the single tap interrupt on the selected interrupt pin.
+/// @param pin the interrupt pin
+/// @param enable enable/disable single tap interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntSingleTap(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.single_tap = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Enables the double tap interrupt on the selected interrupt pin.
+/// @param pin the interrupt pin
+/// @param enable enable/disable double tap interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntDoubleTap(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.double_tap = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Enables the wake up interrupt on the selected interrupt pin.
+/// @param pin the interrupt pin
+/// @param enable enable/disable wakeup interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntWakeup(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.wakeup = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Enables the free fall interrupt on one of the interrupt pins.
+/// @param pin the interrupt pin
+/// @param enable enable/disable freefall interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntFreeFall(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.freefall = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Enables the sleep change interrupt on one of the interrupt pins.
+/// @param pin the interrupt pin
+/// @param enable enable/disable sleep change interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntSleepChange(sfe_lsm_pin_t pin, bool enable)
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.sleep_change = (uint8_t)enable;
+
+    return setIntRoute(int_route, pin);
+}
+
+/// @brief Enables pulsed data ready mode as opposed to latch - 65us pulse.
+/// @param pulse Enable/Disable pulsed interrupts
+///		LSM6DSV16X_DRDY_LATCHED
+///		LSM6DSV16X_DRDY_PULSED
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setDataReadyMode(lsm6dsv16x_data_ready_mode_t pulse)
+{
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_data_ready_mode_set(&sfe_dev, pulse);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Selects latched or pulsed interrupts for the given event classes.
+/// A latched source stays set, and its pin stays active, until its source
+/// register is read. With LSM_INT_CLASS_EVENTS latched, reading ALL_INT_SRC
+/// acknowledges every latched event, but LSM_INT_STATUS alone only reports
+/// wake-up, free-fall, 6D and sleep change from it: a latched tap, sensor hub
+/// or embedded function source is cleared without being reported. Read
+/// LSM_INT_EVENTS and LSM_INT_EMB_STATUS in the same getInterrupts() call,
+/// which reads them first, or keep those bits with setIntAckMask().
+/// @param classes The classes to change, sfe_lsm_int_class_t values OR'd together
+/// @param latched True for latched, false for pulsed
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntLatched(uint8_t classes, bool latched)
+{
+    int32_t retVal = 0;
+
+    if (classes & LSM_INT_CLASS_DATA_READY)
+    {
+        retVal = lsm6dsv16x_data_ready_mode_set(&sfe_dev, latched ? LSM6DSV16X_DRDY_LATCHED : LSM6DSV16X_DRDY_PULSED);
+        if (retVal != 0)
+            return false;
+    }
+
+    if (classes & LSM_INT_CLASS_EVENTS)
+    {
+        lsm6dsv16x_tap_cfg0_t tap_cfg0;
+
+        retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_TAP_CFG0, (uint8_t *)&tap_cfg0, 1);
+        if (retVal != 0)
+            return false;
+
+        tap_cfg0.lir = (uint8_t)latched;
+
+        retVal = lsm6dsv16x_write_reg(&sfe_dev, LSM6DSV16X_TAP_CFG0, (uint8_t *)&tap_cfg0, 1);
+        if (retVal != 0)
+            return false;
+    }
+
+    if (classes & LSM_INT_CLASS_EMB_FUNC)
+    {
+        lsm6dsv16x_page_rw_t page_rw;
+
+        retVal = lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_EMBED_FUNC_MEM_BANK);
+        if (retVal == 0)
+            retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_PAGE_RW, (uint8_t *)&page_rw, 1);
+        if (retVal == 0)
+        {
+            page_rw.emb_func_lir = (uint8_t)latched;
+            retVal = lsm6dsv16x_write_reg(&sfe_dev, LSM6DSV16X_PAGE_RW, (uint8_t *)&page_rw, 1);
+        }
+        retVal += lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_MAIN_MEM_BANK);
+
+        if (retVal != 0)
+            return false;
+    }
+
+    return true;
+}
+
+/// @brief Reads which event classes are latched.
+/// @param classes Set to the latched classes, sfe_lsm_int_class_t values OR'd together
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getIntLatched(uint8_t *classes)
+{
+    int32_t retVal;
+    lsm6dsv16x_data_ready_mode_t drdyMode;
+    lsm6dsv16x_tap_cfg0_t tap_cfg0;
+    lsm6dsv16x_page_rw_t page_rw;
+
+    retVal = lsm6dsv16x_data_ready_mode_get(&sfe_dev, &drdyMode);
+    if (retVal == 0)
+        retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_TAP_CFG0, (uint8_t *)&tap_cfg0, 1);
+    if (retVal != 0)
+        return false;
+
+    retVal = lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_EMBED_FUNC_MEM_BANK);
+    if (retVal == 0)
+        retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_PAGE_RW, (uint8_t *)&page_rw, 1);
+    retVal += lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_MAIN_MEM_BANK);
+
+    if (retVal != 0)
+        return false;
+
+    *classes = 0;
+
+    if (drdyMode == LSM6DSV16X_DRDY_LATCHED)
+        *classes |= LSM_INT_CLASS_DATA_READY;
+    if (tap_cfg0.lir)
+        *classes |= LSM_INT_CLASS_EVENTS;
+    if (page_rw.emb_func_lir)
+        *classes |= LSM_INT_CLASS_EMB_FUNC;
+
+    return true;
+}
+
+/// @brief Sets the interrupt acknowledge mask. The mask bits follow the bits
+/// of ALL_INT_SRC, a latched source whose bit is set is not reset when
+/// ALL_INT_SRC is read, so a read can report everything but acknowledge only
+/// the sources that are serviced. The register is in the embedded function
+/// bank, which the driver's lsm6dsv16x_int_ack_mask_set() does not select.
+/// @param mask sfe_lsm_int_ack_t values OR'd together, bits set keep their sources on a read.
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setIntAckMask(uint8_t mask)
+{
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_EMBED_FUNC_MEM_BANK);
+    if (retVal == 0)
+        retVal = lsm6dsv16x_int_ack_mask_set(&sfe_dev, mask);
+    retVal += lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_MAIN_MEM_BANK);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Reads the interrupt acknowledge mask, see setIntAckMask().
+/// @param mask Set to the mask.
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getIntAckMask(uint8_t *mask)
+{
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_EMBED_FUNC_MEM_BANK);
+    if (retVal == 0)
+        retVal = lsm6dsv16x_int_ack_mask_get(&sfe_dev, mask);
+    retVal += lsm6dsv16x_mem_bank_set(&sfe_dev, LSM6DSV16X_MAIN_MEM_BANK);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Enables the tap interrupt
+/// @param enable Enable/disable the tap interrupt
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::enableTapInterrupt(bool enable)
+{
+
+    int32_t retVal;
+    lsm6dsv16x_interrupt_mode_t intEnable;
+
+    // Keeps the latched mode chosen with setIntLatched()
+    retVal = lsm6dsv16x_interrupt_enable_get(&sfe_dev, &intEnable);
+
+    if (retVal != 0)
+        return false;
+
+    intEnable.enable = (uint8_t)enable;
+
+    retVal = lsm6dsv16x_interrupt_enable_set(&sfe_dev, intEnable);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Enables the selected tap mode: single, double, or single and double
+/// @param mode the tap mode. Two possible settings:
+///		LSM6DSV16X_ONLY_SINGLE
+///		LSM6DSV16X_BOTH_SINGLE_DOUBLE
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setTapMode(lsm6dsv16x_tap_mode_t mode)
+{
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_mode_set(&sfe_dev, mode);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Retrieves the tap mode
+/// @param mode the tap mode
+/// @return Returns -1 on error, otherwise the selected tap mode.
+bool QwDevLSM6DSV16X::getTapMode(lsm6dsv16x_tap_mode_t *mode)
+{
+
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_mode_get(&sfe_dev, mode);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Sets the axis with which to detect taps: x, y, or z.
+/// @param directionDetect the direction to detect
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setTapDirection(lsm6dsv16x_tap_detection_t directionDetect)
+{
+
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_detection_set(&sfe_dev, directionDetect);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Retrieves the active tap axes.
+/// @param directionDetect the direction to detect
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getTapDirection(lsm6dsv16x_tap_detection_t *directionDetect)
+{
+
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_detection_get(&sfe_dev, directionDetect);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Sets the tap thresholds for each of the axes.
+/// @param thresholds the tap sensitivity settings
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setTapThresholds(lsm6dsv16x_tap_thresholds_t thresholds)
+{
+
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_thresholds_set(&sfe_dev, thresholds);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Retrieves the thresholds for each of the axes.
+/// @param thresholds the tap sensitivity settings
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getTapThresholds(lsm6dsv16x_tap_thresholds_t *thresholds)
+{
+
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_thresholds_get(&sfe_dev, thresholds);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Sets the three options for tap "windows": shock, quiet, and tap_gap.
+/// @param window the time duration of the three tap settings
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setTapTimeWindows(lsm6dsv16x_tap_time_windows_t window)
+{
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_time_windows_set(&sfe_dev, window);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Retrieves the three tap window settings.
+/// @param window the time duration of the three tap settings
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::getTapTimeWindows(lsm6dsv16x_tap_time_windows_t *window)
+{
+
+    int32_t retVal;
+
+    retVal = lsm6dsv16x_tap_time_windows_get(&sfe_dev, window);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+////Data Ready Acquisition/////////////////////////////////////////////////////////////////////////
+
+// Timestamp tick length in microseconds with an ODR calibration of zero.
+#define kTimestampTickUs 21.75f
+
+/// @brief Starts interrupt driven acquisition of single samples: the data
+/// ready signal is set to pulse once per sample and routed to the given pin,
+/// and the device timestamp is enabled to tell missed samples apart. Attach an
+/// interrupt on the rising edge of that pin that calls dataReadyISR(), then
+/// call serviceDataReady() from the main loop or a high priority task. Set
+/// the data rates first.
+/// @param pin The interrupt pin.
+/// @param accel Read the accelerometer, its data ready pulse is the trigger.
+/// @param gyro Read the gyroscope, its pulse is the trigger if the accelerometer is not read.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::beginDataReady(sfe_lsm_pin_t pin, bool accel, bool gyro)
+{
+    int32_t retVal = 0;
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    if (!accel && !gyro)
+        return false;
+
+    float hz = dataRateToHz(accel ? accelRate : gyroRate);
+
+    if (hz <= 0.0f)
+        return false;
+
+    drdyActive = false;
+    drdyPending = false;
+    drdyAccel = accel;
+    drdyGyro = gyro;
+    drdyPin = pin;
+
+    // Sample periods and timestamp ticks come from the same oscillator, so the
+    // ODR calibration only changes the length of a tick.
+    retVal = lsm6dsv16x_odr_cal_reg_get(&sfe_dev, &odrCalibration);
+    if (retVal != 0)
+        return false;
+
+    drdyPeriodTicks = 1000000.0f / (hz * kTimestampTickUs);
+    drdyTickUs = kTimestampTickUs / (1.0f + 0.0013f * (float)odrCalibration);
+    resetDataReadyStats();
+
+    if (!enableTimestamp())
+        return false;
+
+    if (!setDataReadyMode(LSM6DSV16X_DRDY_PULSED))
+        return false;
+
+    if (!getIntRoute(&int_route, pin))
+        return false;
+
+    int_route.drdy_xl = (uint8_t)accel;
+    int_route.drdy_g = (uint8_t)!accel;
+
+    if (!setIntRoute(int_route, pin))
+        return false;
+
+    drdyActive = true;
+
+    return true;
+}
+
+/// @brief Stops data ready acquisition and removes the data ready interrupt.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::endDataReady()
+{
+    lsm6dsv16x_pin_int_route_t int_route;
+
+    drdyActive = false;
+    drdyPending = false;
+
+    if (!getIntRoute(&int_route, drdyPin))
+        return false;
+
+    int_route.drdy_xl = 0;
+    int_route.drdy_g = 0;
+
+    return setIntRoute(int_route, drdyPin);
+}
+
+/// @brief Records that a sample is ready, call this from the pin's interrupt
+/// handler. It does not touch the bus.
+void QwDevLSM6DSV16X::dataReadyISR()
 {
+    drdyPending = true;
+}
 
-    lsm6dsv16x_pin_int_route_t int_route;
-    int_route.sleep_change = (uint8_t)enable;
+/// @brief Reads the sample whose data ready pulse arrived, in one burst
+/// followed by the timestamp. STATUS_REG is read first and tells whether the
+/// sample is new. Missed samples are counted against the phase of the samples
+/// tracked from earlier reads, so read latency may vary by up to half a sample
+/// period without false misses.
+/// @param sample Filled with the sample, stale is set when the device had no
+/// new one and the outputs repeat the previous sample.
+/// @return True if a sample was read, false if none was pending.
+bool QwDevLSM6DSV16X::serviceDataReady(sfe_lsm_drdy_sample_t *sample)
+{
+    uint8_t buff[12];
+    lsm6dsv16x_status_reg_t status;
+
+    if (!drdyActive || !drdyPending)
+        return false;
+
+    drdyPending = false;
+
+    // Read on its own, reading the outputs clears the data ready bits.
+    if (readRegisterRegion(LSM6DSV16X_STATUS_REG, (uint8_t *)&status, 1) != 0)
+        return false;
+
+    // OUTX_L_G to OUTZ_H_A, or just the sensors that are read
+    uint8_t first = drdyGyro ? LSM6DSV16X_OUTX_L_G : LSM6DSV16X_OUTX_L_A;
+    uint8_t last = drdyAccel ? LSM6DSV16X_OUTZ_H_A : LSM6DSV16X_OUTZ_H_G;
+
+    if (readRegisterRegion(first, buff, last - first + 1) != 0)
+        return false;
+
+    uint8_t stamp[4];
+
+    if (readRegisterRegion(LSM6DSV16X_TIMESTAMP0, stamp, 4) != 0)
+        return false;
+
+    sample->timestamp = (uint32_t)stamp[0] | ((uint32_t)stamp[1] << 8) | ((uint32_t)stamp[2] << 16) |
+                        ((uint32_t)stamp[3] << 24);
+    sample->accel = {};
+    sample->gyro = {};
+    sample->missed = 0;
+    sample->stale = !(drdyAccel ? status.xlda : status.gda);
 
-    if (setIntRoute(int_route, pin))
+    const uint8_t *accel = &buff[drdyGyro ? 6 : 0];
+
+    if (drdyGyro)
+    {
+        sample->gyro.xData = (int16_t)((uint16_t)buff[1] << 8 | buff[0]);
+        sample->gyro.yData = (int16_t)((uint16_t)buff[3] << 8 | buff[2]);
+        sample->gyro.zData = (int16_t)((uint16_t)buff[5] << 8 | buff[4]);
+    }
+    if (drdyAccel)
+    {
+        sample->accel.xData = (int16_t)((uint16_t)accel[1] << 8 | accel[0]);
+        sample->accel.yData = (int16_t)((uint16_t)accel[3] << 8 | accel[2]);
+        sample->accel.zData = (int16_t)((uint16_t)accel[5] << 8 | accel[4]);
+    }
+
+    // A pulse without a new sample, e.g. noise on the line.
+    if (sample->stale)
+    {
+        drdyStats.stale++;
+        return true;
+    }
+
+    if (!drdyStarted)
+    {
+        drdyStarted = true;
+        drdyFirstStamp = sample->timestamp;
+        drdyLastStamp = sample->timestamp;
+        drdyPhase = 0;
+        drdyStats.samples++;
         return true;
+    }
 
-    return false;
+    uint32_t delta = sample->timestamp - drdyLastStamp;
+
+    // Ticks since the previous sample was produced, rounded to whole periods.
+    float elapsed = (float)delta - drdyPhase;
+    uint32_t periods = (uint32_t)(elapsed / drdyPeriodTicks + 0.5f);
+
+    if (periods == 0)
+        periods = 1;
+
+    // Reads never come before their sample: an earlier read than the tracked
+    // phase moves it back at once, a later one only drifts it slowly. The
+    // phase follows the shortest latency and the oscillator, not the jitter.
+    float late = elapsed - (float)periods * drdyPeriodTicks;
+
+    drdyPhase = (late < 0.0f) ? 0.0f : -late * (63.0f / 64.0f);
+
+    sample->missed = (periods - 1 > 0xFFFF) ? 0xFFFF : (uint16_t)(periods - 1);
+    drdyStats.missed += periods - 1;
+    drdyStats.samples++;
+    drdyLastStamp = sample->timestamp;
+
+    // Running mean and variance of the period (Welford), over gaps without misses
+    if (periods == 1)
+    {
+        float periodUs = (float)delta * drdyTickUs;
+        float diff = periodUs - drdyMeanUs;
+
+        drdyPeriods++;
+        drdyMeanUs += diff / (float)drdyPeriods;
+        drdyM2 += diff * (periodUs - drdyMeanUs);
+
+        if (drdyPeriods == 1 || periodUs < drdyStats.minPeriodUs)
+            drdyStats.minPeriodUs = periodUs;
+        if (periodUs > drdyStats.maxPeriodUs)
+            drdyStats.maxPeriodUs = periodUs;
+    }
+
+    return true;
 }
 
-/// @brief Enables pulsed data ready mode as opposed to latch - 65us pulse.
-/// @param pulse Enable/Disable pulsed interrupts
-///		LSM6DSV16X_DRDY_LATCHED
-///		LSM6DSV16X_DRDY_PULSED
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setDataReadyMode(lsm6dsv16x_data_ready_mode_t pulse)
+/// @brief Returns the data ready acquisition statistics collected since
+/// beginDataReady() or the last resetDataReadyStats().
+/// @return The statistics
+sfe_lsm_drdy_stats_t QwDevLSM6DSV16X::getDataReadyStats()
+{
+    sfe_lsm_drdy_stats_t stats = drdyStats;
+    uint32_t elapsed = drdyLastStamp - drdyFirstStamp;
+
+    stats.expectedPeriodUs = drdyPeriodTicks * drdyTickUs;
+    stats.meanPeriodUs = drdyMeanUs;
+    stats.readJitterUs = (drdyPeriods > 1) ? sqrtf(drdyM2 / (float)(drdyPeriods - 1)) : 0.0f;
+    stats.rateHz = (elapsed > 0) ? (float)(stats.samples - 1) * 1000000.0f / ((float)elapsed * drdyTickUs) : 0.0f;
+
+    return stats;
+}
+
+/// @brief Clears the data ready acquisition statistics, the next sample read
+/// starts a new measurement.
+void QwDevLSM6DSV16X::resetDataReadyStats()
+{
+    drdyStats = {};
+    drdyStarted = false;
+    drdyFirstStamp = 0;
+    drdyLastStamp = 0;
+    drdyPhase = 0;
+    drdyPeriods = 0;
+    drdyMeanUs = 0;
+    drdyM2 = 0;
+}
+
+////Events///////////////////////////////////////////////////////////////////////////////////////
+
+// Source register group holding each event.
+static const uint8_t kEventGroup[LSM_EVENT_NUM] = {
+    LSM_INT_EVENTS,     LSM_INT_EVENTS,     LSM_INT_EVENTS,     LSM_INT_EVENTS,     LSM_INT_EVENTS,
+    LSM_INT_EVENTS,     LSM_INT_STATUS,     LSM_INT_STATUS,     LSM_INT_STATUS,     LSM_INT_STATUS,
+    LSM_INT_STATUS,     LSM_INT_EMB_STATUS, LSM_INT_EMB_STATUS, LSM_INT_EMB_STATUS, LSM_INT_EMB_STATUS,
+    LSM_INT_EMB_STATUS};
+
+static bool eventFired(const lsm6dsv16x_all_sources_t &source, uint8_t event)
+{
+    switch (event)
+    {
+    case LSM_EVENT_SINGLE_TAP:
+        return source.single_tap;
+    case LSM_EVENT_DOUBLE_TAP:
+        return source.double_tap;
+    case LSM_EVENT_WAKEUP:
+        return source.wake_up;
+    case LSM_EVENT_FREE_FALL:
+        return source.free_fall;
+    case LSM_EVENT_SIX_D:
+        return source.six_d;
+    case LSM_EVENT_SLEEP_CHANGE:
+        return source.sleep_change;
+    case LSM_EVENT_FIFO_WATERMARK:
+        return source.fifo_th;
+    case LSM_EVENT_FIFO_FULL:
+        return source.fifo_full;
+    case LSM_EVENT_FIFO_OVERRUN:
+        return source.fifo_ovr;
+    case LSM_EVENT_ACCEL_DATA_READY:
+        return source.drdy_xl;
+    case LSM_EVENT_GYRO_DATA_READY:
+        return source.drdy_gy;
+    case LSM_EVENT_STEP:
+        return source.step_detector;
+    case LSM_EVENT_TILT:
+        return source.tilt;
+    case LSM_EVENT_SIG_MOTION:
+        return source.sig_mot;
+    case LSM_EVENT_FSM:
+        return source.fsm1 || source.fsm2 || source.fsm3 || source.fsm4 || source.fsm5 || source.fsm6 ||
+               source.fsm7 || source.fsm8;
+    case LSM_EVENT_MLC:
+        return source.mlc1 || source.mlc2 || source.mlc3 || source.mlc4;
+    default:
+        return false;
+    }
+}
+
+/// @brief Registers a function that serviceEvents() calls whenever the event
+/// is found. The event still has to be enabled and routed to the pin whose
+/// interrupt calls eventISR(), e.g. with setIntSingleTap().
+/// @param event The event.
+/// @param handler The function to call, nullptr to remove it.
+/// @param context Passed through to the handler unchanged.
+void QwDevLSM6DSV16X::setEventHandler(sfe_lsm_event_t event, sfe_lsm_event_handler_t handler, void *context)
+{
+    if (event >= LSM_EVENT_NUM)
+        return;
+
+    eventHandler[event] = handler;
+    eventContext[event] = context;
+
+    eventGroups = 0;
+    for (uint8_t i = 0; i < LSM_EVENT_NUM; i++)
+    {
+        if (eventHandler[i] != nullptr)
+            eventGroups |= kEventGroup[i];
+    }
+}
+
+/// @brief Notes that the interrupt pin went active. Call it from the pin's
+/// interrupt handler, it does not access the bus.
+void QwDevLSM6DSV16X::eventISR()
+{
+    eventPending = true;
+}
+
+/// @brief Reads the interrupt sources once if eventISR() was called since the
+/// last pass, and calls the handler of every event found. Only the register
+/// groups holding events with a handler are read, in one burst each. Pulsed
+/// event sources may have cleared by the time they are read, latched ones
+/// are held until this read.
+/// @return The number of handlers called.
+uint8_t QwDevLSM6DSV16X::serviceEvents()
+{
+    lsm6dsv16x_all_sources_t source;
+    uint8_t dispatched = 0;
+
+    if (!eventPending || eventGroups == 0)
+        return 0;
+
+    // Cleared first, an interrupt during the read is serviced on the next pass.
+    eventPending = false;
+
+    if (!getInterrupts(&source, eventGroups))
+    {
+        eventPending = true;
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < LSM_EVENT_NUM; i++)
+    {
+        if (eventHandler[i] != nullptr && eventFired(source, i))
+        {
+            eventHandler[i]((sfe_lsm_event_t)i, &source, eventContext[i]);
+            dispatched++;
+        }
+    }
+
+    return dispatched;
+}
+
+////Activity/Inactivity////////////////////////////////////////////////////////////////////////
+
+/// @brief Selects what the device does to the sensors while it is inactive.
+/// @param mode The inactive behaviour:
+///		LSM6DSV16X_XL_AND_GY_NOT_AFFECTED
+///		LSM6DSV16X_XL_LOW_POWER_GY_NOT_AFFECTED
+///		LSM6DSV16X_XL_LOW_POWER_GY_SLEEP
+///		LSM6DSV16X_XL_LOW_POWER_GY_POWER_DOWN
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setActivityMode(lsm6dsv16x_act_mode_t mode)
 {
     int32_t retVal;
 
-    retVal = lsm6dsv16x_data_ready_mode_set(&sfe_dev, pulse);
+    retVal = lsm6dsv16x_act_mode_set(&sfe_dev, mode);
 
     if (retVal != 0)
         return false;
@@ -1089,18 +3579,18 @@ bool QwDevLSM6DSV16X::setDataReadyMode(lsm6dsv16x_data_ready_mode_t pulse)
     return true;
 }
 
-/// @brief Enables the tap interrupt
-/// @param enable Enable/disable the tap interrupt
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::enableTapInterrupt(bool enable)
+/// @brief Sets the accelerometer data rate used while inactive.
+/// @param rate The data rate:
+///		LSM6DSV16X_1Hz875
+///		LSM6DSV16X_15Hz
+///		LSM6DSV16X_30Hz
+///		LSM6DSV16X_60Hz
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setInactivityAccelDataRate(lsm6dsv16x_act_sleep_xl_odr_t rate)
 {
-
     int32_t retVal;
-    lsm6dsv16x_interrupt_mode_t intEnable;
-
-    intEnable.enable = (uint8_t)enable;
 
-    retVal = lsm6dsv16x_interrupt_enable_set(&sfe_dev, intEnable);
+    retVal = lsm6dsv16x_act_sleep_xl_odr_set(&sfe_dev, rate);
 
     if (retVal != 0)
         return false;
@@ -1108,16 +3598,17 @@ bool QwDevLSM6DSV16X::enableTapInterrupt(bool enable)
     return true;
 }
 
-/// @brief Enables the selected tap mode: single, double, or single and double
-/// @param mode the tap mode. Two possible settings:
-///		LSM6DSV16X_ONLY_SINGLE
-///		LSM6DSV16X_BOTH_SINGLE_DOUBLE
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setTapMode(lsm6dsv16x_tap_mode_t mode)
+/// @brief Sets the wake-up threshold and duration and the inactivity
+/// threshold. This also writes the inactive data rate in inactivity_cfg,
+/// set it there or call setInactivityAccelDataRate() afterwards.
+/// @param thresholds The thresholds, in units of the weight in
+/// inactivity_cfg.wu_inact_ths_w (7.8125mg to 250mg per LSB).
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setActivityThresholds(lsm6dsv16x_act_thresholds_t thresholds)
 {
     int32_t retVal;
 
-    retVal = lsm6dsv16x_tap_mode_set(&sfe_dev, mode);
+    retVal = lsm6dsv16x_act_thresholds_set(&sfe_dev, &thresholds);
 
     if (retVal != 0)
         return false;
@@ -1125,15 +3616,16 @@ bool QwDevLSM6DSV16X::setTapMode(lsm6dsv16x_tap_mode_t mode)
     return true;
 }
 
-/// @brief Retrieves the tap mode
-/// @param mode the tap mode
-/// @return Returns -1 on error, otherwise the selected tap mode.
-bool QwDevLSM6DSV16X::getTapMode(lsm6dsv16x_tap_mode_t *mode)
+/// @brief Sets how long motion must last to wake the device (shock, 1/ODR
+/// per LSB) and how long it must be still to go inactive (quiet, 512/ODR per
+/// LSB), both at the active accelerometer data rate.
+/// @param windows The time windows
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setActivityTimeWindows(lsm6dsv16x_act_wkup_time_windows_t windows)
 {
-
     int32_t retVal;
 
-    retVal = lsm6dsv16x_tap_mode_get(&sfe_dev, mode);
+    retVal = lsm6dsv16x_act_wkup_time_windows_set(&sfe_dev, windows);
 
     if (retVal != 0)
         return false;
@@ -1141,47 +3633,145 @@ bool QwDevLSM6DSV16X::getTapMode(lsm6dsv16x_tap_mode_t *mode)
     return true;
 }
 
-/// @brief Sets the axis with which to detect taps: x, y, or z.
-/// @param directionDetect the direction to detect
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setTapDirection(lsm6dsv16x_tap_detection_t directionDetect)
+/// @brief Lets the device power itself down while still: after the quiet
+/// time it drops the accelerometer to the sleep rate and idles the gyroscope
+/// as the mode says, on motion above the wake-up threshold it restores both
+/// without the microcontroller. The sleep change is routed to the pin and
+/// passed to the handler set with setActivityHandler() by serviceEvents().
+/// Event interrupts are latched until endAutoPowerDown(), see setIntLatched(),
+/// so that a change stays pending until serviceEvents() reads it however late
+/// the loop gets to it. This applies to tap, wake-up, free-fall and 6D too.
+/// Set the thresholds and time windows first.
+/// @param pin The pin whose interrupt calls eventISR()
+/// @param mode What the device does to the sensors while inactive
+/// @param sleepRate The accelerometer data rate while inactive
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::beginAutoPowerDown(sfe_lsm_pin_t pin, lsm6dsv16x_act_mode_t mode,
+                                         lsm6dsv16x_act_sleep_xl_odr_t sleepRate)
 {
-
     int32_t retVal;
+    lsm6dsv16x_interrupt_mode_t intEnable;
 
-    retVal = lsm6dsv16x_tap_detection_set(&sfe_dev, directionDetect);
+    if (!setInactivityAccelDataRate(sleepRate))
+        return false;
+
+    // The sleep change is one of the basic interrupts, which need enabling.
+    retVal = lsm6dsv16x_interrupt_enable_get(&sfe_dev, &intEnable);
+    if (retVal != 0)
+        return false;
 
+    intEnable.enable = 1;
+
+    retVal = lsm6dsv16x_interrupt_enable_set(&sfe_dev, intEnable);
     if (retVal != 0)
         return false;
 
+    if (!setActivityMode(mode))
+        return false;
+
+    // A pulsed sleep change is cleared again before a slow loop reads it.
+    uint8_t latched;
+
+    if (!getIntLatched(&latched))
+        return false;
+
+    activityWasLatched = (latched & LSM_INT_CLASS_EVENTS) != 0;
+
+    if (!setIntLatched(LSM_INT_CLASS_EVENTS))
+        return false;
+
+    if (!setIntSleepChange(pin, true))
+        return false;
+
+    activityPin = pin;
+    activityReported = false;
+    setEventHandler(LSM_EVENT_SLEEP_CHANGE, activityEvent, this);
+
     return true;
 }
 
-/// @brief Retrieves the active tap axes.
-/// @param directionDetect the direction to detect
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::getTapDirection(lsm6dsv16x_tap_detection_t *directionDetect)
+/// @brief Stops the automatic power down, the sensors stay at their set data
+/// rates. Event interrupts return to the latched or pulsed mode they had before
+/// beginAutoPowerDown(), basic interrupts stay enabled for other events.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::endAutoPowerDown()
+{
+    setEventHandler(LSM_EVENT_SLEEP_CHANGE, nullptr);
+
+    if (!setActivityMode(LSM6DSV16X_XL_AND_GY_NOT_AFFECTED))
+        return false;
+
+    if (!setIntSleepChange(activityPin, false))
+        return false;
+
+    return setIntLatched(LSM_INT_CLASS_EVENTS, activityWasLatched);
+}
+
+/// @brief Registers the function called when the device becomes active or
+/// inactive. It replaces a handler set for LSM_EVENT_SLEEP_CHANGE while the
+/// automatic power down runs.
+/// @param handler The function to call, nullptr to remove it.
+/// @param context Passed through to the handler unchanged.
+void QwDevLSM6DSV16X::setActivityHandler(sfe_lsm_activity_handler_t handler, void *context)
 {
+    activityHandler = handler;
+    activityContext = context;
+}
 
+/// @brief Reads whether the device is active, e.g. to find the state at
+/// start up. With latched events this acknowledges the wake-up sources.
+/// @param active Set to false while the device is inactive.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::getActivityState(bool *active)
+{
     int32_t retVal;
+    lsm6dsv16x_wake_up_src_t wake_up_src;
 
-    retVal = lsm6dsv16x_tap_detection_get(&sfe_dev, directionDetect);
+    retVal = lsm6dsv16x_read_reg(&sfe_dev, LSM6DSV16X_WAKE_UP_SRC, (uint8_t *)&wake_up_src, 1);
 
     if (retVal != 0)
         return false;
 
+    *active = (wake_up_src.sleep_state == 0);
+
     return true;
 }
 
-/// @brief Sets the tap thresholds for each of the axes.
-/// @param thresholds the tap sensitivity settings
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setTapThresholds(lsm6dsv16x_tap_thresholds_t thresholds)
+void QwDevLSM6DSV16X::activityEvent(sfe_lsm_event_t event, const lsm6dsv16x_all_sources_t *source, void *context)
 {
+    QwDevLSM6DSV16X *device = (QwDevLSM6DSV16X *)context;
+    bool active = (source->sleep_state == 0);
+
+    (void)event;
+
+    // The state now, a quick change back and forth arrives as the same state
+    // and is not reported again.
+    if (device->activityReported && active == device->activityActive)
+        return;
+
+    device->activityReported = true;
+    device->activityActive = active;
+
+    if (device->activityHandler != nullptr)
+        device->activityHandler(active, device->activityContext);
+}
 
+////Step Counter/////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Enables the pedometer embedded function. It needs the accelerometer
+/// running at 30Hz or faster.
+/// @param enable Enables/disables the step counter
+/// @param falseStepRejection Enables/disables the false step rejection
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::enableStepCounter(bool enable, bool falseStepRejection)
+{
     int32_t retVal;
+    lsm6dsv16x_stpcnt_mode_t mode;
 
-    retVal = lsm6dsv16x_tap_thresholds_set(&sfe_dev, thresholds);
+    mode.step_counter_enable = (uint8_t)enable;
+    mode.false_step_rej = (uint8_t)falseStepRejection;
+
+    retVal = lsm6dsv16x_stpcnt_mode_set(&sfe_dev, mode);
 
     if (retVal != 0)
         return false;
@@ -1189,15 +3779,14 @@ bool QwDevLSM6DSV16X::setTapThresholds(lsm6dsv16x_tap_thresholds_t thresholds)
     return true;
 }
 
-/// @brief Retrieves the thresholds for each of the axes.
-/// @param thresholds the tap sensitivity settings
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::getTapThresholds(lsm6dsv16x_tap_thresholds_t *thresholds)
+/// @brief Retrieves the number of steps counted.
+/// @param steps The step count
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::getStepCount(uint16_t *steps)
 {
-
     int32_t retVal;
 
-    retVal = lsm6dsv16x_tap_thresholds_get(&sfe_dev, thresholds);
+    retVal = lsm6dsv16x_stpcnt_steps_get(&sfe_dev, steps);
 
     if (retVal != 0)
         return false;
@@ -1205,14 +3794,13 @@ bool QwDevLSM6DSV16X::getTapThresholds(lsm6dsv16x_tap_thresholds_t *thresholds)
     return true;
 }
 
-/// @brief Sets the three options for tap "windows": shock, quiet, and tap_gap.
-/// @param window the time duration of the three tap settings
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::setTapTimeWindows(lsm6dsv16x_tap_time_windows_t window)
+/// @brief Sets the step count back to zero.
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::resetStepCounter()
 {
     int32_t retVal;
 
-    retVal = lsm6dsv16x_tap_time_windows_set(&sfe_dev, window);
+    retVal = lsm6dsv16x_stpcnt_rst_step_set(&sfe_dev, 1);
 
     if (retVal != 0)
         return false;
@@ -1220,15 +3808,50 @@ bool QwDevLSM6DSV16X::setTapTimeWindows(lsm6dsv16x_tap_time_windows_t window)
     return true;
 }
 
-/// @brief Retrieves the three tap window settings.
-/// @param window the time duration of the three tap settings
-/// @return Returns true on successful execution
-bool QwDevLSM6DSV16X::getTapTimeWindows(lsm6dsv16x_tap_time_windows_t *window)
+////Sensor Fusion Low Power/////////////////////////////////////////////////////////////////////////
+
+/// @brief Enables the sensor fusion low power block, which computes the game
+/// rotation vector, gravity vector and gyroscope bias from the accelerometer
+/// and gyroscope. Both sensors need to be running.
+/// @param rate The SFLP output data rate:
+///		LSM6DSV16X_SFLP_15Hz
+///		LSM6DSV16X_SFLP_30Hz
+///		LSM6DSV16X_SFLP_60Hz
+///		LSM6DSV16X_SFLP_120Hz
+///		LSM6DSV16X_SFLP_240Hz
+///		LSM6DSV16X_SFLP_480Hz
+/// @param enable Enables/disables SFLP
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::enableSFLP(lsm6dsv16x_sflp_data_rate_t rate, bool enable)
 {
+    int32_t retVal;
 
+    retVal = lsm6dsv16x_sflp_data_rate_set(&sfe_dev, rate);
+    retVal += lsm6dsv16x_sflp_game_rotation_set(&sfe_dev, (uint8_t)enable);
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Selects which SFLP outputs are batched into the FIFO. The decoder
+/// delivers them as LSM_FIFO_GAME_ROTATION (quaternion), LSM_FIFO_GRAVITY (mg)
+/// and LSM_FIFO_GYRO_BIAS (mdps) samples.
+/// @param gameRotation Batch the game rotation vector
+/// @param gravity Batch the gravity vector
+/// @param gyroBias Batch the gyroscope bias
+/// @return True on successful execution
+bool QwDevLSM6DSV16X::setSFLPFifoBatch(bool gameRotation, bool gravity, bool gyroBias)
+{
     int32_t retVal;
+    lsm6dsv16x_fifo_sflp_raw_t sflpBatch;
 
-    retVal = lsm6dsv16x_tap_time_windows_get(&sfe_dev, window);
+    sflpBatch.game_rotation = (uint8_t)gameRotation;
+    sflpBatch.gravity = (uint8_t)gravity;
+    sflpBatch.gbias = (uint8_t)gyroBias;
+
+    retVal = lsm6dsv16x_fifo_sflp_batch_set(&sfe_dev, sflpBatch);
 
     if (retVal != 0)
         return false;
@@ -1293,23 +3916,75 @@ bool QwDevLSM6DSV16X::setQvarImpedance(lsm6dsv16x_ah_qvar_zin_t val)
     return true;
 }
 
-/// @brief Retrieves the data ready bit for the Qvar channel.
+/// @brief Retrieves the data ready bit for the Qvar channel. Only STATUS_REG
+/// is read.
 /// @return Returns true on if the bit is one.
 bool QwDevLSM6DSV16X::checkQvar()
 {
-    lsm6dsv16x_all_sources_t tempVal;
+    lsm6dsv16x_status_reg_t tempVal;
 
-    int32_t retVal = lsm6dsv16x_all_sources_get(&sfe_dev, &tempVal);
+    int32_t retVal = readRegisterRegion(LSM6DSV16X_STATUS_REG, (uint8_t *)&tempVal, 1);
 
     if (retVal != 0)
         return false;
 
-    if (tempVal.drdy_ah_qvar == 1)
+    if (tempVal.ah_qvarda == 1)
         return true;
 
     return false;
 }
 
+/// @brief Reads STATUS_REG and, only if it flags a new Qvar sample, the Qvar
+/// output registers. They are two small reads: one burst across the
+/// registers in between would read the temperature, gyroscope and
+/// accelerometer outputs too and clear their data ready bits.
+/// @param qvarData Raw analog data, left untouched when no new sample is ready.
+/// @return Returns true when a new Qvar sample was read.
+bool QwDevLSM6DSV16X::getQvarIfReady(int16_t *qvarData)
+{
+    lsm6dsv16x_status_reg_t status;
+    uint8_t buff[2];
+
+    int32_t retVal = readRegisterRegion(LSM6DSV16X_STATUS_REG, (uint8_t *)&status, 1);
+
+    if (retVal != 0)
+        return false;
+
+    if (status.ah_qvarda == 0)
+        return false;
+
+    retVal = readRegisterRegion(LSM6DSV16X_AH_QVAR_OUT_L, buff, 2);
+
+    if (retVal != 0)
+        return false;
+
+    *qvarData = (int16_t)((buff[1] << 8) | buff[0]);
+
+    return true;
+}
+
+/// @brief Fills a buffer with consecutive Qvar samples at the configured data rate,
+/// polling with getQvarIfReady().
+/// @param buffer Destination for the raw Qvar samples.
+/// @param numSamples The number of samples to capture.
+/// @param timeoutMs Give up after this many milliseconds without filling the buffer.
+/// @return Returns the number of samples captured.
+uint16_t QwDevLSM6DSV16X::captureQvar(int16_t *buffer, uint16_t numSamples, uint32_t timeoutMs)
+{
+    uint16_t captured = 0;
+    uint32_t start = millis();
+
+    while (captured < numSamples)
+    {
+        if (getQvarIfReady(&buffer[captured]))
+            captured++;
+        else if ((millis() - start) > timeoutMs)
+            break;
+    }
+
+    return captured;
+}
+
 //
 //
 //////////////////////////////////////////////////////////////////////////////////
@@ -1553,6 +4228,58 @@ bool QwDevLSM6DSV16X::resetSensorHub()
 
     return true;
 }
+
+/// @brief Batches the data read from a downstream sensor into the FIFO, at the
+/// sensor hub's rate. Up to six bytes of the sensor's read (see setHubSensorRead)
+/// end up in each FIFO word, time aligned with the accelerometer and gyroscope.
+/// @param sensor the sensor to batch 0 - 3
+/// @param enable enable/disable batching
+/// @return Returns true on successful execution
+bool QwDevLSM6DSV16X::setHubFifoBatch(uint8_t sensor, bool enable)
+{
+    int32_t retVal;
+
+    switch (sensor)
+    {
+    case 0:
+        retVal = lsm6dsv16x_fifo_batch_sh_slave_0_set(&sfe_dev, (uint8_t)enable);
+        break;
+    case 1:
+        retVal = lsm6dsv16x_fifo_batch_sh_slave_1_set(&sfe_dev, (uint8_t)enable);
+        break;
+    case 2:
+        retVal = lsm6dsv16x_fifo_batch_sh_slave_2_set(&sfe_dev, (uint8_t)enable);
+        break;
+    case 3:
+        retVal = lsm6dsv16x_fifo_batch_sh_slave_3_set(&sfe_dev, (uint8_t)enable);
+        break;
+    default:
+        return false;
+    }
+
+    if (retVal != 0)
+        return false;
+
+    return true;
+}
+
+/// @brief Registers the function processFifo() calls for the FIFO words of one
+/// downstream sensor.
+/// @param sensor the sensor 0 - 3
+/// @param handler The function to call, nullptr removes the handler.
+/// @param context Passed through to the handler unchanged.
+/// @param scale Applied to the word's three little endian 16-bit values to fill
+/// the sample's vector, e.g. a magnetometer's sensitivity.
+void QwDevLSM6DSV16X::setHubFifoHandler(uint8_t sensor, sfe_lsm_fifo_handler_t handler, void *context, float scale)
+{
+    bool changed = (scale != fifoDecoder.getSensorHubScale(sensor));
+
+    fifoDecoder.setSensorHubHandler(sensor, handler, context);
+    fifoDecoder.setSensorHubScale(sensor, scale);
+
+    if (fifoLog != nullptr && changed && sensor < 4)
+        fifoLog->writeHubScale(sensor, scale, millis());
+}
 //
 //
 //////////////////////////////////////////////////////////////////////////////////
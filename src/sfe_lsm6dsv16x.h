@@ -1,5 +1,8 @@
 #include "sfe_bus.h"
 #include "sfe_lsm_shim.h"
+#include "sfe_lsm_fifo.h"
+#include "sfe_lsm_log.h"
+#include "sfe_lsm_ring.h"
 
 /*
  * Link to example code:
@@ -11,26 +14,190 @@
 #define LSM6DSV16X_ADDRESS_HIGH 0x6B
 #define LSM6DSV16X_ADDRESS_SECONDARY 0x6B
 
+// Size of the driver owned receive buffer in bytes. The default is a multiple of
+// both 6 (one x/y/z triplet) and 7 (one tagged FIFO word), larger buffers let
+// a single FIFO burst move more words. 8 bit parts get six FIFO words per burst.
+#ifndef SFE_LSM6DSV16X_RX_BUFFER_SIZE
+#if defined(__AVR__)
+#define SFE_LSM6DSV16X_RX_BUFFER_SIZE 42
+#else
+#define SFE_LSM6DSV16X_RX_BUFFER_SIZE 252
+#endif
+#endif
+
+// Alignment of the receive buffer, one data cache line on Cortex-M7 parts so
+// that a DMA transfer into it never shares a line with other data. The buffer
+// is padded to a whole number of lines. 8 bit parts have no cache.
+#ifndef SFE_LSM6DSV16X_RX_BUFFER_ALIGN
+#if defined(__AVR__)
+#define SFE_LSM6DSV16X_RX_BUFFER_ALIGN 1
+#else
+#define SFE_LSM6DSV16X_RX_BUFFER_ALIGN 32
+#endif
+#endif
+
 typedef enum
 {
     LSM_PIN_ONE = 0x01,
     LSM_PIN_TWO
 } sfe_lsm_pin_t;
 
-struct sfe_lsm_raw_data_t
+// Signals routed to both interrupt pins, see setIntRoutePlan().
+struct sfe_lsm_int_plan_t
 {
-    int16_t xData;
-    int16_t yData;
-    int16_t zData;
+    lsm6dsv16x_pin_int_route_t int1;
+    lsm6dsv16x_pin_int_route_t int2;
 };
 
-struct sfe_lsm_data_t
+// Channels that can be served from the ODR-aware read cache, may be OR'd together.
+typedef enum
 {
-    float xData;
-    float yData;
-    float zData;
+    LSM_CACHE_TEMP = 0x01,
+    LSM_CACHE_ACCEL = 0x02,
+    LSM_CACHE_GYRO = 0x04,
+    LSM_CACHE_ALL = 0x07
+} sfe_lsm_cache_channel_t;
+
+struct sfe_lsm_cache_stats_t
+{
+    uint32_t hits;   // Reads answered from the cache, only STATUS_REG is read
+    uint32_t misses; // Reads that went to the device
 };
 
+// FIFO health, collected on every drain of the FIFO.
+struct sfe_lsm_fifo_stats_t
+{
+    uint32_t drains;         // FIFO reads that returned words
+    uint32_t wordsRead;      // Total words read
+    uint32_t overruns;       // Drains that found FIFO_OVR set, older words were overwritten
+    uint32_t fullEvents;     // Drains that found FIFO_FULL set
+    uint32_t droppedSamples; // Accel and gyro samples missing between the words decoded by processFifo() or
+                             // getFifoDecoder(), handled or not. Words read with readFifoBatch() and the
+                             // like count once decoded. Without batched timestamps a gap of a multiple of
+                             // four batch periods, e.g. after an overrun, is not seen, see overruns.
+    uint16_t peakLevel;      // Highest FIFO level found at a drain
+    uint16_t lastLevel;      // FIFO level found at the last drain
+    uint32_t lastLatencyUs;  // Watermark interrupt to drain, streaming only
+    uint32_t maxLatencyUs;
+    uint32_t totalLatencyUs; // Divide by latencyCount for the average
+    uint32_t latencyCount;
+};
+
+// One sample read on its data ready pulse.
+struct sfe_lsm_drdy_sample_t
+{
+    uint32_t timestamp;       // Device timestamp at the read, ticks of about 21.75us
+    sfe_lsm_raw_data_t accel; // Zero unless the accelerometer is read
+    sfe_lsm_raw_data_t gyro;  // Zero unless the gyroscope is read
+    uint16_t missed;          // Samples the device produced since the previous read that were not read
+    bool stale;               // No new sample since the previous read, the outputs repeat it
+};
+
+// Data ready acquisition health, the periods are measured with the device timestamp.
+struct sfe_lsm_drdy_stats_t
+{
+    uint32_t samples;       // Samples read
+    uint32_t missed;        // Samples produced but not read
+    uint32_t stale;         // Reads that found no new sample
+    float expectedPeriodUs; // From the data rate and the ODR calibration
+    float meanPeriodUs;     // Between the reads of consecutive samples, gaps with misses left out
+    float readJitterUs;     // Standard deviation of that period: read latency jitter, not sensor timing
+    float minPeriodUs;
+    float maxPeriodUs;
+    float rateHz; // Samples read per second of device time
+};
+
+// Interrupt events that can end a triggered FIFO capture.
+typedef enum
+{
+    LSM_CAPTURE_WAKEUP = 0x00,
+    LSM_CAPTURE_FREE_FALL,
+    LSM_CAPTURE_SINGLE_TAP,
+    LSM_CAPTURE_DOUBLE_TAP,
+    LSM_CAPTURE_EMB_FUNC // FSM or MLC outputs routed to the embedded function interrupt
+} sfe_lsm_capture_event_t;
+
+typedef enum
+{
+    LSM_CAPTURE_IDLE = 0x00, // Not armed, or the window has been read
+    LSM_CAPTURE_ARMED,       // Waiting for the event
+    LSM_CAPTURE_POST,        // Event seen, collecting the samples after it
+    LSM_CAPTURE_DONE         // The window is frozen in the FIFO, see readFifoCapture()
+} sfe_lsm_capture_state_t;
+
+// Groups of interrupt source registers, may be OR'd together. Each group is
+// read in one bus transaction, except LSM_INT_EMB_BANK which switches banks.
+typedef enum
+{
+    LSM_INT_STATUS = 0x01,     // FIFO status, ALL_INT_SRC and STATUS_REG: data ready and FIFO flags
+    LSM_INT_EVENTS = 0x02,     // Wake-up, free-fall, sleep change, tap and 6D sources
+    LSM_INT_EMB_STATUS = 0x04, // Sensor hub, embedded function, FSM and MLC status
+    LSM_INT_EMB_BANK = 0x08,   // Embedded function execution and step counter sources
+    LSM_INT_ALL = 0x0F
+} sfe_lsm_int_group_t;
+
+// Interrupt classes that are latched or pulsed on their own, may be OR'd
+// together, see setIntLatched().
+typedef enum
+{
+    LSM_INT_CLASS_DATA_READY = 0x01, // Accelerometer, gyroscope and temperature data ready
+    LSM_INT_CLASS_EVENTS = 0x02,     // Wake-up, free-fall, sleep change, tap and 6D
+    LSM_INT_CLASS_EMB_FUNC = 0x04,   // Step detector, tilt, significant motion, FSM and MLC
+    LSM_INT_CLASS_ALL = 0x07
+} sfe_lsm_int_class_t;
+
+// Interrupt acknowledge mask bits, one per ALL_INT_SRC source, may be OR'd
+// together, see setIntAckMask().
+typedef enum
+{
+    LSM_INT_ACK_FREE_FALL = 0x01,
+    LSM_INT_ACK_WAKEUP = 0x02,
+    LSM_INT_ACK_TAP = 0x04, // Single and double tap
+    LSM_INT_ACK_SIX_D = 0x10,
+    LSM_INT_ACK_SLEEP_CHANGE = 0x20,
+    LSM_INT_ACK_SHUB = 0x40,     // Sensor hub
+    LSM_INT_ACK_EMB_FUNC = 0x80, // Embedded functions, FSM and MLC
+    LSM_INT_ACK_ALL = 0xF7
+} sfe_lsm_int_ack_t;
+
+// Events dispatched by serviceEvents().
+typedef enum
+{
+    LSM_EVENT_SINGLE_TAP = 0x00,
+    LSM_EVENT_DOUBLE_TAP,
+    LSM_EVENT_WAKEUP,
+    LSM_EVENT_FREE_FALL,
+    LSM_EVENT_SIX_D,
+    LSM_EVENT_SLEEP_CHANGE, // See sleep_state in the sources for the new state
+    LSM_EVENT_FIFO_WATERMARK,
+    LSM_EVENT_FIFO_FULL,
+    LSM_EVENT_FIFO_OVERRUN,
+    LSM_EVENT_ACCEL_DATA_READY,
+    LSM_EVENT_GYRO_DATA_READY,
+    LSM_EVENT_STEP,
+    LSM_EVENT_TILT,
+    LSM_EVENT_SIG_MOTION,
+    LSM_EVENT_FSM, // Any of the FSM outputs, see fsm1 to fsm8 in the sources
+    LSM_EVENT_MLC, // Any of the MLC outputs, see mlc1 to mlc4 in the sources
+    LSM_EVENT_NUM
+} sfe_lsm_event_t;
+
+// Called by serviceEvents() when the device enters or leaves its inactive
+// state, see beginAutoPowerDown().
+typedef void (*sfe_lsm_activity_handler_t)(bool active, void *context);
+
+// Called by serviceEvents() for every event found, with all sources read in that pass.
+typedef void (*sfe_lsm_event_handler_t)(sfe_lsm_event_t event, const lsm6dsv16x_all_sources_t *source,
+                                        void *context);
+
+// What the receive buffer holds after the last burst read.
+typedef enum
+{
+    LSM_BURST_NONE = 0x00,
+    LSM_BURST_TRIPLETS,
+    LSM_BURST_FIFO
+} sfe_lsm_burst_t;
+
 class QwDevLSM6DSV16X
 {
   public:
@@ -60,6 +227,17 @@ class QwDevLSM6DSV16X
     bool getRawQvar(int16_t *qvarData);
     bool getAccel(sfe_lsm_data_t *accelData);
     bool getGyro(sfe_lsm_data_t *gyroData);
+    bool readRawAccelGyro();
+
+    // Zero-copy views of the last burst held in the driver's receive buffer.
+    // A view stays valid until the next call that reads sensor data through
+    // the buffer: getRawTemp/Accel/Gyro, getAccel/Gyro, readRawAccelGyro or a
+    // FIFO read into the internal buffer. Calls served from the read cache do
+    // not touch the buffer. Views return nullptr when the last burst was of a
+    // different kind.
+    const uint8_t *getBurstBytes(uint16_t *length);
+    const int16_t *getBurstTriplets(uint16_t *count);
+    const sfe_lsm_fifo_word_t *getBurstFifoWords(uint16_t *count);
 
     // General Settings
     // bool setDeviceConfig(bool enable = true);
@@ -83,10 +261,22 @@ class QwDevLSM6DSV16X
     bool enableFilterSettling(bool enable = true);
     // bool resetTimestamp();
 
+    // Read Cache
+    bool enableReadCache(uint8_t channels, bool enable = true);
+    void invalidateReadCache(uint8_t channels = LSM_CACHE_ALL);
+    sfe_lsm_cache_stats_t getReadCacheStats(sfe_lsm_cache_channel_t channel);
+    void resetReadCacheStats();
+
     // Interrupt Settings
     bool getAllInterrupts(lsm6dsv16x_all_sources_t *source);
+    bool getInterrupts(lsm6dsv16x_all_sources_t *source, uint8_t groups);
+    bool getEnabledInterrupts(lsm6dsv16x_all_sources_t *source);
+    uint8_t getEnabledInterruptGroups();
     bool setInt2DENActiveLow(bool activeLow = true);
     bool setIntRoute(lsm6dsv16x_pin_int_route_t val, sfe_lsm_pin_t pin);
+    bool getIntRoute(lsm6dsv16x_pin_int_route_t *val, sfe_lsm_pin_t pin);
+    bool setIntRoutePlan(const sfe_lsm_int_plan_t &plan);
+    bool getIntRoutePlan(sfe_lsm_int_plan_t *plan);
     bool setIntAccelDataReady(sfe_lsm_pin_t pin, bool enable = true);
     bool setIntGyroDataReady(sfe_lsm_pin_t pin, bool enable = true);
     bool setIntSingleTap(sfe_lsm_pin_t pin, bool enable = true);
@@ -96,6 +286,10 @@ class QwDevLSM6DSV16X
     bool setIntSleepChange(sfe_lsm_pin_t pin, bool enable = true);
 
     bool setDataReadyMode(lsm6dsv16x_data_ready_mode_t);
+    bool setIntLatched(uint8_t classes, bool latched = true);
+    bool getIntLatched(uint8_t *classes);
+    bool setIntAckMask(uint8_t mask);
+    bool getIntAckMask(uint8_t *mask);
 
     // Tap Settings
     bool enableTapInterrupt(bool enable = true);
@@ -108,10 +302,33 @@ class QwDevLSM6DSV16X
     bool setTapTimeWindows(lsm6dsv16x_tap_time_windows_t window);
     bool getTapTimeWindows(lsm6dsv16x_tap_time_windows_t *window);
 
+    // Activity/Inactivity, the device lowers the accelerometer data rate and
+    // idles the gyroscope by itself while still, and restores both on motion
+    bool setActivityMode(lsm6dsv16x_act_mode_t mode);
+    bool setInactivityAccelDataRate(lsm6dsv16x_act_sleep_xl_odr_t rate);
+    bool setActivityThresholds(lsm6dsv16x_act_thresholds_t thresholds);
+    bool setActivityTimeWindows(lsm6dsv16x_act_wkup_time_windows_t windows);
+    bool beginAutoPowerDown(sfe_lsm_pin_t pin, lsm6dsv16x_act_mode_t mode = LSM6DSV16X_XL_LOW_POWER_GY_POWER_DOWN,
+                            lsm6dsv16x_act_sleep_xl_odr_t sleepRate = LSM6DSV16X_1Hz875);
+    bool endAutoPowerDown();
+    void setActivityHandler(sfe_lsm_activity_handler_t handler, void *context = nullptr);
+    bool getActivityState(bool *active);
+
+    // Step Counter
+    bool enableStepCounter(bool enable = true, bool falseStepRejection = false);
+    bool getStepCount(uint16_t *steps);
+    bool resetStepCounter();
+
+    // Sensor Fusion Low Power (SFLP)
+    bool enableSFLP(lsm6dsv16x_sflp_data_rate_t rate, bool enable = true);
+    bool setSFLPFifoBatch(bool gameRotation, bool gravity, bool gyroBias);
+
     // Qvar Settings
     bool enableAhQvar(bool enable = true);
     bool getQvarMode(lsm6dsv16x_ah_qvar_mode_t *mode);
     bool setQvarImpedance(lsm6dsv16x_ah_qvar_zin_t val);
+    bool getQvarIfReady(int16_t *qvarData);
+    uint16_t captureQvar(int16_t *buffer, uint16_t numSamples, uint32_t timeoutMs = 1000);
 
     // Sensor Hub Settings
     bool setHubODR(lsm6dsv16x_sh_data_rate_t rate);
@@ -125,6 +342,8 @@ class QwDevLSM6DSV16X
     bool enableHubPassThrough(bool enable = true);
     bool enableHubPullUps(bool enable = true);
     bool resetSensorHub();
+    bool setHubFifoBatch(uint8_t sensor, bool enable = true);
+    void setHubFifoHandler(uint8_t sensor, sfe_lsm_fifo_handler_t handler, void *context = nullptr, float scale = 1.0f);
 
     // Self Test
     bool setAccelSelfTest(lsm6dsv16x_xl_self_test_t val);
@@ -136,6 +355,78 @@ class QwDevLSM6DSV16X
     bool setAccelFifoBatchSet(lsm6dsv16x_fifo_xl_batch_t odr);
     bool setGyroFifoBatchSet(lsm6dsv16x_fifo_gy_batch_t odr);
     bool setFifoTimestampDec(lsm6dsv16x_fifo_timestamp_batch_t decimation);
+    bool setTempFifoBatch(lsm6dsv16x_fifo_temp_batch_t rate);
+    bool setStepCounterFifoBatch(bool enable = true);
+    bool setMLCFifoBatch(bool enable = true);
+    bool setMLCFilterFifoBatch(bool enable = true);
+    bool enableFifoCompression(bool enable = true);
+    bool setFifoUncompressedRate(lsm6dsv16x_fifo_compress_algo_t rate);
+    bool enableFifoConfigChange(bool enable = true);
+    bool getFifoStatus(lsm6dsv16x_fifo_status_t *status);
+    uint16_t readFifoBatch(sfe_lsm_fifo_word_t *buffer, uint16_t maxWords);
+    uint16_t readFifoBatch(uint16_t maxWords = 0xFFFF);
+    uint16_t readFifoBatch(sfe_lsm_fifo_word_t *first, uint16_t firstWords, sfe_lsm_fifo_word_t *second,
+                           uint16_t secondWords);
+    void setFifoHandler(sfe_lsm_fifo_type_t type, sfe_lsm_fifo_handler_t handler, void *context = nullptr);
+    SfeLSMFifoDecoder &getFifoDecoder();
+    void setFifoLog(SfeLSMFifoLogWriter *log);
+    uint16_t processFifo(uint16_t maxWords = 0xFFFF);
+
+    // FIFO Streaming, the watermark interrupt drains the FIFO into one of two buffers
+    bool setIntFifoWatermark(sfe_lsm_pin_t pin, bool enable = true);
+    bool beginFifoStream(sfe_lsm_fifo_word_t *bufferA, sfe_lsm_fifo_word_t *bufferB, uint16_t bufferWords,
+                         uint8_t watermark, sfe_lsm_pin_t pin);
+    bool endFifoStream();
+    void fifoWatermarkISR();
+    uint16_t serviceFifoStream();
+    const sfe_lsm_fifo_word_t *getFifoStreamBuffer(uint16_t *count);
+    void releaseFifoStreamBuffer(const sfe_lsm_fifo_word_t *buffer);
+    sfe_lsm_fifo_stats_t getFifoStats();
+    void resetFifoStats();
+    bool enableAdaptiveWatermark(uint8_t minWatermark, uint8_t maxWatermark, uint16_t maxFill = 384);
+    void disableAdaptiveWatermark();
+    uint8_t getFifoWatermark();
+
+    // FIFO Frames, the batch counter interrupt marks every complete frame of samples
+    bool setFifoBatchCounter(uint16_t threshold,
+                             lsm6dsv16x_fifo_batch_cnt_event_t trigger = LSM6DSV16X_XL_BATCH_EVENT);
+    bool setIntFifoBatchCounter(sfe_lsm_pin_t pin, bool enable = true);
+    bool beginFifoFrames(sfe_lsm_fifo_word_t *buffer, uint16_t bufferWords, uint16_t frameSamples, sfe_lsm_pin_t pin,
+                         lsm6dsv16x_fifo_batch_cnt_event_t trigger = LSM6DSV16X_XL_BATCH_EVENT);
+    bool endFifoFrames();
+    void fifoFrameISR();
+    const sfe_lsm_fifo_word_t *readFifoFrame(uint16_t *count);
+
+    // FIFO Capture, a window of words around an interrupt event is frozen in the FIFO
+    bool armFifoCapture(sfe_lsm_capture_event_t event, uint8_t preWords, uint8_t postWords, sfe_lsm_pin_t pin);
+    bool disarmFifoCapture();
+    void fifoCaptureISR();
+    sfe_lsm_capture_state_t serviceFifoCapture();
+    uint16_t readFifoCapture(sfe_lsm_fifo_word_t *buffer, uint16_t maxWords);
+
+    // Data ready acquisition, every sample is read once on its data ready pulse
+    bool beginDataReady(sfe_lsm_pin_t pin, bool accel = true, bool gyro = false);
+    bool endDataReady();
+    void dataReadyISR();
+    bool serviceDataReady(sfe_lsm_drdy_sample_t *sample);
+    template <uint16_t N> bool serviceDataReady(SfeLSMRing<sfe_lsm_drdy_sample_t, N> &ring);
+    sfe_lsm_drdy_stats_t getDataReadyStats();
+    void resetDataReadyStats();
+
+    // Acquisition into a sample ring, from an interrupt handler where the bus
+    // driver allows it or from a high priority task. The main loop drains
+    // the ring; a full ring drops the reading and counts an overflow.
+    template <uint16_t N> bool readRawAccel(SfeLSMRing<sfe_lsm_raw_sample_t, N> &ring);
+    template <uint16_t N> bool readRawGyro(SfeLSMRing<sfe_lsm_raw_sample_t, N> &ring);
+    template <uint16_t N> bool readAccel(SfeLSMRing<sfe_lsm_sample_t, N> &ring);
+    template <uint16_t N> bool readGyro(SfeLSMRing<sfe_lsm_sample_t, N> &ring);
+    template <uint16_t N> uint16_t readFifoBatch(SfeLSMRing<sfe_lsm_fifo_word_t, N> &ring);
+
+    // Events, the pin interrupt notes that an interrupt happened and
+    // serviceEvents() reads the sources and calls the handlers
+    void setEventHandler(sfe_lsm_event_t event, sfe_lsm_event_handler_t handler, void *context = nullptr);
+    void eventISR();
+    uint8_t serviceEvents();
 
     // Status
     bool checkStatus();
@@ -166,4 +457,255 @@ class QwDevLSM6DSV16X
     bool gyroScaleSet = false;
     lsm6dsv16x_xl_full_scale_t fullScaleAccel; // Powered down by default
     lsm6dsv16x_gy_full_scale_t fullScaleGyro;  // Powered down by default
+
+    // Receive buffer, every burst lands here so it can be parsed in place.
+    int32_t readBurst(uint8_t reg, uint16_t length, sfe_lsm_burst_t kind);
+    const int16_t *readRawWords(uint8_t cacheIndex, uint8_t reg, uint8_t count);
+    alignas(SFE_LSM6DSV16X_RX_BUFFER_ALIGN) union {
+        uint8_t bytes[SFE_LSM6DSV16X_RX_BUFFER_SIZE];
+        int16_t words[SFE_LSM6DSV16X_RX_BUFFER_SIZE / 2];
+        sfe_lsm_fifo_word_t fifo[SFE_LSM6DSV16X_RX_BUFFER_SIZE / sizeof(sfe_lsm_fifo_word_t)];
+        uint8_t lines[(SFE_LSM6DSV16X_RX_BUFFER_SIZE + SFE_LSM6DSV16X_RX_BUFFER_ALIGN - 1) /
+                      SFE_LSM6DSV16X_RX_BUFFER_ALIGN * SFE_LSM6DSV16X_RX_BUFFER_ALIGN];
+    } rxBuffer;
+    uint16_t rxLength = 0;
+    sfe_lsm_burst_t rxKind = LSM_BURST_NONE;
+
+    // Signals routed to each interrupt pin, as last written by setIntRoute()
+    lsm6dsv16x_pin_int_route_t intRoute[2] = {};
+
+    // Read cache, indexed 0 = temperature, 1 = accelerometer, 2 = gyroscope
+    bool cacheLookup(uint8_t index);
+    void cacheStore(uint8_t index, const int16_t *data, uint8_t length);
+    void updateCachePeriods();
+    lsm6dsv16x_data_rate_t accelRate = LSM6DSV16X_ODR_OFF;
+    lsm6dsv16x_data_rate_t gyroRate = LSM6DSV16X_ODR_OFF;
+    int8_t odrCalibration = 0;
+    uint8_t cacheEnabled = 0;
+    uint8_t cacheValid = 0;
+    int16_t cacheData[3][3];
+    uint32_t cacheStamp[3];
+    uint32_t cachePeriodUs[3] = {0, 0, 0};
+    sfe_lsm_cache_stats_t cacheStats[3] = {};
+
+    // Decodes FIFO words for processFifo(), kept in step with the full scale
+    // settings, batch rates and ODR calibration
+    bool updateFifoTiming();
+    void updateFifoConfig(bool calibrationChanged = false);
+    SfeLSMFifoDecoder fifoDecoder;
+    SfeLSMFifoLogWriter *fifoLog = nullptr;
+    uint8_t accelBatch = LSM6DSV16X_XL_NOT_BATCHED;
+    uint8_t gyroBatch = LSM6DSV16X_GY_NOT_BATCHED;
+    lsm6dsv16x_fifo_mode_t fifoMode = LSM6DSV16X_BYPASS_MODE;
+    bool fifoConfigChange = false;
+
+    // FIFO streaming double buffer, each buffer is free, ready or held by the application
+    sfe_lsm_fifo_word_t *streamBuffer[2] = {nullptr, nullptr};
+    uint16_t streamCapacity = 0;
+    uint16_t streamCount[2] = {0, 0};
+    uint8_t streamState[2] = {0, 0};
+    uint32_t streamSequence[2] = {0, 0};
+    uint32_t streamNextSequence = 0;
+    sfe_lsm_pin_t streamPin = LSM_PIN_ONE;
+    bool streamActive = false;
+    volatile bool streamPending = false;
+    volatile uint32_t streamIrqMicros = 0;
+
+    // FIFO frames, the buffer holds the frame handed out last followed by the
+    // words read beyond it
+    sfe_lsm_fifo_word_t *frameBuffer = nullptr;
+    uint16_t frameCapacity = 0;
+    uint16_t frameSamples = 0;
+    uint16_t frameWords = 0;
+    uint16_t frameLength = 0;
+    uint8_t frameTrigger = LSM6DSV16X_XL_BATCH_EVENT;
+    sfe_lsm_pin_t framePin = LSM_PIN_ONE;
+    bool frameActive = false;
+    volatile bool framePending = false;
+    volatile uint32_t frameIrqMicros = 0;
+
+    // FIFO statistics, updated from the FIFO status read at each drain
+    bool readFifoLevel(uint16_t *level);
+    sfe_lsm_fifo_stats_t fifoStats = {};
+    bool fifoReadFailed = false; // The last batch read into caller buffers hit a bus error
+
+    // Triggered FIFO capture
+    bool setCaptureRoute(bool event, bool watermark);
+    sfe_lsm_capture_event_t captureEvent = LSM_CAPTURE_WAKEUP;
+    sfe_lsm_capture_state_t captureState = LSM_CAPTURE_IDLE;
+    uint8_t capturePre = 0;
+    uint8_t capturePost = 0;
+    sfe_lsm_pin_t capturePin = LSM_PIN_ONE;
+    volatile bool capturePending = false;
+
+    // Data ready acquisition, the period is counted in timestamp ticks
+    bool drdyActive = false;
+    bool drdyAccel = true;
+    bool drdyGyro = false;
+    bool drdyStarted = false;
+    sfe_lsm_pin_t drdyPin = LSM_PIN_ONE;
+    volatile bool drdyPending = false;
+    float drdyPeriodTicks = 0;
+    float drdyTickUs = 0;
+    uint32_t drdyFirstStamp = 0;
+    uint32_t drdyLastStamp = 0;
+    float drdyPhase = 0; // Ticks from the last read back to its sample, at most 0
+    uint32_t drdyPeriods = 0;
+    float drdyMeanUs = 0;
+    float drdyM2 = 0;
+    sfe_lsm_drdy_stats_t drdyStats = {};
+
+    // Event dispatch, the groups cover the sources of the events with a handler
+    sfe_lsm_event_handler_t eventHandler[LSM_EVENT_NUM] = {};
+    void *eventContext[LSM_EVENT_NUM] = {};
+    uint8_t eventGroups = 0;
+    volatile bool eventPending = false;
+
+    // Auto power down, sleep change events are passed on as state changes
+    static void activityEvent(sfe_lsm_event_t event, const lsm6dsv16x_all_sources_t *source, void *context);
+    sfe_lsm_activity_handler_t activityHandler = nullptr;
+    void *activityContext = nullptr;
+    sfe_lsm_pin_t activityPin = LSM_PIN_ONE;
+    bool activityReported = false; // activityActive holds the last state passed to the handler
+    bool activityActive = true;
+    bool activityWasLatched = false; // Event latching before beginAutoPowerDown(), restored at the end
+
+    // Adaptive watermark, retuned after every streaming drain
+    void tuneFifoWatermark();
+    uint8_t fifoWatermark = 0;
+    bool watermarkAdaptive = false;
+    uint8_t watermarkMin = 0;
+    uint8_t watermarkMax = 0;
+    uint16_t watermarkMaxFill = 0;
+    uint32_t watermarkOvershootQ4 = 0; // Words, 4 fractional bits
+    uint32_t watermarkOverruns = 0;
 };
+
+/// @brief Reads the accelerometer into the next free slot of a ring, stamped
+/// with micros().
+/// @param ring The ring, this is its producer side.
+/// @return False if the ring was full or the read failed.
+template <uint16_t N> bool QwDevLSM6DSV16X::readRawAccel(SfeLSMRing<sfe_lsm_raw_sample_t, N> &ring)
+{
+    sfe_lsm_raw_sample_t *slot = ring.reserve();
+
+    if (slot == nullptr)
+        return false;
+
+    slot->timeUs = micros();
+    if (!getRawAccel(&slot->data))
+        return false;
+
+    ring.commit();
+
+    return true;
+}
+
+/// @brief Reads the gyroscope into the next free slot of a ring, stamped with
+/// micros().
+/// @param ring The ring, this is its producer side.
+/// @return False if the ring was full or the read failed.
+template <uint16_t N> bool QwDevLSM6DSV16X::readRawGyro(SfeLSMRing<sfe_lsm_raw_sample_t, N> &ring)
+{
+    sfe_lsm_raw_sample_t *slot = ring.reserve();
+
+    if (slot == nullptr)
+        return false;
+
+    slot->timeUs = micros();
+    if (!getRawGyro(&slot->data))
+        return false;
+
+    ring.commit();
+
+    return true;
+}
+
+/// @brief Reads the accelerometer in mg into the next free slot of a ring,
+/// stamped with micros().
+/// @param ring The ring, this is its producer side.
+/// @return False if the ring was full or the read failed.
+template <uint16_t N> bool QwDevLSM6DSV16X::readAccel(SfeLSMRing<sfe_lsm_sample_t, N> &ring)
+{
+    sfe_lsm_sample_t *slot = ring.reserve();
+
+    if (slot == nullptr)
+        return false;
+
+    slot->timeUs = micros();
+    if (!getAccel(&slot->data))
+        return false;
+
+    ring.commit();
+
+    return true;
+}
+
+/// @brief Reads the gyroscope in mdps into the next free slot of a ring,
+/// stamped with micros().
+/// @param ring The ring, this is its producer side.
+/// @return False if the ring was full or the read failed.
+template <uint16_t N> bool QwDevLSM6DSV16X::readGyro(SfeLSMRing<sfe_lsm_sample_t, N> &ring)
+{
+    sfe_lsm_sample_t *slot = ring.reserve();
+
+    if (slot == nullptr)
+        return false;
+
+    slot->timeUs = micros();
+    if (!getGyro(&slot->data))
+        return false;
+
+    ring.commit();
+
+    return true;
+}
+
+/// @brief Reads the sample whose data ready pulse arrived into the next free
+/// slot of a ring, see serviceDataReady(sfe_lsm_drdy_sample_t *).
+/// @param ring The ring, this is its producer side.
+/// @return True if a sample was read and stored.
+template <uint16_t N> bool QwDevLSM6DSV16X::serviceDataReady(SfeLSMRing<sfe_lsm_drdy_sample_t, N> &ring)
+{
+    if (!drdyPending)
+        return false;
+
+    // Left pending, the device timestamp counts the samples lost meanwhile. A
+    // full ring is checked first, reserve() would count an overflow per poll.
+    if (ring.available() >= ring.capacity())
+        return false;
+
+    sfe_lsm_drdy_sample_t *slot = ring.reserve();
+
+    if (slot == nullptr)
+        return false;
+
+    if (!serviceDataReady(slot))
+        return false;
+
+    ring.commit();
+
+    return true;
+}
+
+/// @brief Drains the FIFO straight into the free slots of a ring, in at most
+/// two bursts when the free space wraps. Words that do not fit stay in the
+/// FIFO for the next call.
+/// @param ring The ring, this is its producer side.
+/// @return The number of words read.
+template <uint16_t N> uint16_t QwDevLSM6DSV16X::readFifoBatch(SfeLSMRing<sfe_lsm_fifo_word_t, N> &ring)
+{
+    sfe_lsm_fifo_word_t *first;
+    sfe_lsm_fifo_word_t *second;
+    uint16_t firstWords;
+    uint16_t secondWords;
+
+    if (ring.reserveSpan(&first, &firstWords, &second, &secondWords) == 0)
+        return 0;
+
+    uint16_t count = readFifoBatch(first, firstWords, second, secondWords);
+
+    ring.commit(count);
+
+    return count;
+}
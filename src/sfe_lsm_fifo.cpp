@@ -0,0 +1,738 @@
+#include "sfe_lsm_fifo.h"
+#include <string.h>
+
+// How the six data bytes of a word are turned into a sample.
+typedef enum
+{
+    kConvertNone = 0x00, // Raw words and a pointer to the bytes only
+    kConvertAccel,
+    kConvertGyro,
+    kConvertTemp,
+    kConvertTimestamp,
+    kConvertStepCounter,
+    kConvertGravity,
+    kConvertGyroBias,
+    kConvertGameRotation,
+    kConvertSensorHub,
+    kConvertMlcResult,
+    kConvertMlcFeature, // Filters and features alike
+    kConvertNcT2, // Uncompressed sample, two batch periods old
+    kConvertNcT1, // Uncompressed sample, one batch period old
+    kConvert2xc,  // Two samples as 8-bit deltas
+    kConvert3xc   // Three samples as 5-bit deltas
+} fifoConvert_t;
+
+struct fifoTagInfo_t
+{
+    uint8_t type;    // sfe_lsm_fifo_type_t
+    uint8_t convert; // fifoConvert_t
+    uint8_t slot;
+    uint8_t handler; // Index into the decoder's handlers
+};
+
+// Sensor hub slots have their own handlers after the per type ones.
+#define kSensorHubHandler(slot) (LSM_FIFO_NUM_TYPES + (slot))
+
+// Indexed by the five bit tag sensor field. Reserved tags map onto
+// LSM_FIFO_UNKNOWN.
+static const fifoTagInfo_t kTagTable[32] = {
+    {LSM_FIFO_UNKNOWN, kConvertNone, 0, LSM_FIFO_UNKNOWN},                      // 0x00
+    {LSM_FIFO_GYRO, kConvertGyro, 0, LSM_FIFO_GYRO},                            // 0x01 GY_NC
+    {LSM_FIFO_ACCEL, kConvertAccel, 0, LSM_FIFO_ACCEL},                         // 0x02 XL_NC
+    {LSM_FIFO_TEMP, kConvertTemp, 0, LSM_FIFO_TEMP},                            // 0x03 TEMPERATURE
+    {LSM_FIFO_TIMESTAMP, kConvertTimestamp, 0, LSM_FIFO_TIMESTAMP},             // 0x04 TIMESTAMP
+    {LSM_FIFO_CFG_CHANGE, kConvertNone, 0, LSM_FIFO_CFG_CHANGE},                // 0x05 CFG_CHANGE
+    {LSM_FIFO_ACCEL, kConvertNcT2, 0, LSM_FIFO_ACCEL},                          // 0x06 XL_NC_T_2
+    {LSM_FIFO_ACCEL, kConvertNcT1, 0, LSM_FIFO_ACCEL},                          // 0x07 XL_NC_T_1
+    {LSM_FIFO_ACCEL, kConvert2xc, 0, LSM_FIFO_ACCEL},                           // 0x08 XL_2XC
+    {LSM_FIFO_ACCEL, kConvert3xc, 0, LSM_FIFO_ACCEL},                           // 0x09 XL_3XC
+    {LSM_FIFO_GYRO, kConvertNcT2, 0, LSM_FIFO_GYRO},                            // 0x0A GY_NC_T_2
+    {LSM_FIFO_GYRO, kConvertNcT1, 0, LSM_FIFO_GYRO},                            // 0x0B GY_NC_T_1
+    {LSM_FIFO_GYRO, kConvert2xc, 0, LSM_FIFO_GYRO},                             // 0x0C GY_2XC
+    {LSM_FIFO_GYRO, kConvert3xc, 0, LSM_FIFO_GYRO},                             // 0x0D GY_3XC
+    {LSM_FIFO_SENSOR_HUB, kConvertSensorHub, 0, kSensorHubHandler(0)},          // 0x0E SENSORHUB_SLAVE0
+    {LSM_FIFO_SENSOR_HUB, kConvertSensorHub, 1, kSensorHubHandler(1)},          // 0x0F SENSORHUB_SLAVE1
+    {LSM_FIFO_SENSOR_HUB, kConvertSensorHub, 2, kSensorHubHandler(2)},          // 0x10 SENSORHUB_SLAVE2
+    {LSM_FIFO_SENSOR_HUB, kConvertSensorHub, 3, kSensorHubHandler(3)},          // 0x11 SENSORHUB_SLAVE3
+    {LSM_FIFO_STEP_COUNTER, kConvertStepCounter, 0, LSM_FIFO_STEP_COUNTER},     // 0x12 STEP_COUNTER
+    {LSM_FIFO_GAME_ROTATION, kConvertGameRotation, 0, LSM_FIFO_GAME_ROTATION},  // 0x13 SFLP_GAME_ROTATION_VECTOR
+    {LSM_FIFO_UNKNOWN, kConvertNone, 0, LSM_FIFO_UNKNOWN},                      // 0x14
+    {LSM_FIFO_UNKNOWN, kConvertNone, 0, LSM_FIFO_UNKNOWN},                      // 0x15
+    {LSM_FIFO_GYRO_BIAS, kConvertGyroBias, 0, LSM_FIFO_GYRO_BIAS},              // 0x16 SFLP_GYROSCOPE_BIAS
+    {LSM_FIFO_GRAVITY, kConvertGravity, 0, LSM_FIFO_GRAVITY},                   // 0x17 SFLP_GRAVITY_VECTOR
+    {LSM_FIFO_UNKNOWN, kConvertNone, 0, LSM_FIFO_UNKNOWN},                      // 0x18
+    {LSM_FIFO_SENSOR_HUB_NACK, kConvertNone, 0, LSM_FIFO_SENSOR_HUB_NACK},      // 0x19 SENSORHUB_NACK
+    {LSM_FIFO_MLC_RESULT, kConvertMlcResult, 0, LSM_FIFO_MLC_RESULT},           // 0x1A MLC_RESULT
+    {LSM_FIFO_MLC_FILTER, kConvertMlcFeature, 0, LSM_FIFO_MLC_FILTER},          // 0x1B MLC_FILTER
+    {LSM_FIFO_MLC_FEATURE, kConvertMlcFeature, 0, LSM_FIFO_MLC_FEATURE},        // 0x1C MLC_FEATURE
+    {LSM_FIFO_ACCEL_DUAL, kConvertNone, 0, LSM_FIFO_ACCEL_DUAL},                // 0x1D XL_DUAL_CORE
+    {LSM_FIFO_GYRO_EIS, kConvertNone, 0, LSM_FIFO_GYRO_EIS},                    // 0x1E GY_ENHANCED_EIS
+    {LSM_FIFO_UNKNOWN, kConvertNone, 0, LSM_FIFO_UNKNOWN},                      // 0x1F
+};
+
+// Timestamp tick length in picoseconds with an ODR calibration of zero.
+#define kTickPeriodPs 21750000UL
+
+// Sensitivities of each full scale setting, indexed by the register value.
+// These match lsm6dsv16x_from_fsXX_to_mg() and lsm6dsv16x_from_fsXXX_to_mdps().
+static const float kAccelSensitivity[4] = {0.061f, 0.122f, 0.244f, 0.488f};
+static const float kGyroSensitivity[6] = {4.375f, 8.75f, 17.5f, 35.0f, 70.0f, 140.0f};
+
+// Converts an IEEE 754 half precision value to a float by moving the exponent
+// and mantissa into place and rebiasing the exponent, no table needed.
+static inline float halfToFloat(uint16_t half)
+{
+    const uint32_t shiftedExp = 0x7C00UL << 13;
+    uint32_t bits = ((uint32_t)half & 0x7FFF) << 13;
+    uint32_t exp = bits & shiftedExp;
+    float value;
+
+    bits += (uint32_t)(127 - 15) << 23;
+
+    if (exp == shiftedExp)
+    {
+        // Infinity or NaN
+        bits += (uint32_t)(128 - 16) << 23;
+        memcpy(&value, &bits, sizeof(value));
+    }
+    else if (exp == 0)
+    {
+        // Subnormal, renormalise through the FPU
+        const uint32_t magicBits = (uint32_t)113 << 23;
+        float magic;
+        bits += (uint32_t)1 << 23;
+        memcpy(&value, &bits, sizeof(value));
+        memcpy(&magic, &magicBits, sizeof(magic));
+        value -= magic;
+    }
+    else
+    {
+        memcpy(&value, &bits, sizeof(value));
+    }
+
+    return (half & 0x8000) ? -value : value;
+}
+
+SfeLSMFifoDecoder::SfeLSMFifoDecoder()
+{
+    clearHandlers();
+    resetCompression();
+    resetTimeline();
+    resetDroppedSamples();
+    pendingFirst = 0;
+    pendingCount = 0;
+    for (uint8_t slot = 0; slot < 4; slot++)
+        sensorHubScale[slot] = 1.0f;
+    setAccelFullScale(LSM6DSV16X_2g);
+    setGyroFullScale(LSM6DSV16X_125dps);
+    setOdrCalibration(0);
+    setBatchRates(0.0f, 0.0f);
+}
+
+/// @brief Sets the full scale used to convert accelerometer words, this has to
+/// match the setting the words were batched with.
+/// @param scale The accelerometer full scale, LSM6DSV16X_2g - LSM6DSV16X_16g
+void SfeLSMFifoDecoder::setAccelFullScale(lsm6dsv16x_xl_full_scale_t scale)
+{
+    if ((uint8_t)scale < sizeof(kAccelSensitivity) / sizeof(float))
+    {
+        accelSensitivity = kAccelSensitivity[scale];
+        config.accelScale = scale;
+    }
+}
+
+/// @brief Sets the full scale used to convert gyroscope words, this has to
+/// match the setting the words were batched with.
+/// @param scale The gyroscope full scale, LSM6DSV16X_125dps - LSM6DSV16X_4000dps
+void SfeLSMFifoDecoder::setGyroFullScale(lsm6dsv16x_gy_full_scale_t scale)
+{
+    if ((uint8_t)scale < sizeof(kGyroSensitivity) / sizeof(float))
+    {
+        gyroSensitivity = kGyroSensitivity[scale];
+        config.gyroScale = scale;
+    }
+}
+
+/// @brief Sets the nominal FIFO batch rates. They are used to time the
+/// samples that follow the first TIMESTAMP word, until a second one gives a
+/// measured period, and to space the samples of compressed words.
+/// @param accelHz Accelerometer batch rate, zero if not batched.
+/// @param gyroHz Gyroscope batch rate, zero if not batched.
+void SfeLSMFifoDecoder::setBatchRates(float accelHz, float gyroHz)
+{
+    float stepHz = (accelHz > gyroHz) ? accelHz : gyroHz;
+    uint64_t stepTicks = (stepHz > 0.0f) ? (uint64_t)(65536.0f * 1.0e12f / (kTickPeriodPs * stepHz)) : 0;
+
+    config.accelBatchHz = accelHz;
+    config.gyroBatchHz = gyroHz;
+
+    periodSteps[0] = (accelHz > 0.0f) ? (uint8_t)(stepHz / accelHz + 0.5f) : 1;
+    periodSteps[1] = (gyroHz > 0.0f) ? (uint8_t)(stepHz / gyroHz + 0.5f) : 1;
+
+    // A new step length mid-stream: move the base to the current step and
+    // carry on with the nominal length until the next TIMESTAMP word. Sample
+    // gaps across the change can't be told from the steps.
+    if (anchorValid && stepTicks != nominalStepTicksQ16)
+    {
+        baseTicks = ((baseTicks << 16) + (tagStep - baseStep) * stepTicksQ16) >> 16;
+        baseStep = tagStep;
+        stepTicksQ16 = stepTicks;
+        baseInterpolated = true;
+        sampleStepValid[0] = false;
+        sampleStepValid[1] = false;
+    }
+
+    // Both the batch rates and the timestamp counter run off the same trimmed
+    // oscillator, so the step length in ticks does not depend on the trim.
+    nominalStepTicksQ16 = stepTicks;
+}
+
+/// @brief Sets the ODR calibration used to convert timestamp ticks to time,
+/// as read with lsm6dsv16x_odr_cal_reg_get(). Each LSB trims the oscillator by 0.13%.
+/// @param freqFine The INTERNAL_FREQ value.
+void SfeLSMFifoDecoder::setOdrCalibration(int8_t freqFine)
+{
+    tickPeriodPs = (uint32_t)(kTickPeriodPs / (1.0f + 0.0013f * (float)freqFine));
+    odrCalibration = freqFine;
+}
+
+/// @brief Returns the ODR calibration set with setOdrCalibration().
+/// @return The INTERNAL_FREQ value.
+int8_t SfeLSMFifoDecoder::getOdrCalibration()
+{
+    return odrCalibration;
+}
+
+/// @brief Sets the full scales and batch rates used for the words decoded from
+/// now on.
+/// @param config The settings.
+void SfeLSMFifoDecoder::setConfig(const sfe_lsm_fifo_config_t &config)
+{
+    setAccelFullScale(config.accelScale);
+    setGyroFullScale(config.gyroScale);
+    setBatchRates(config.accelBatchHz, config.gyroBatchHz);
+}
+
+/// @brief Queues settings that were changed while the FIFO was batching. The
+/// words already in the FIFO still use the old full scales and batch rates, the
+/// queued settings apply from the next CFG_CHANGE word on, see
+/// lsm6dsv16x_fifo_virtual_sens_odr_chg_set(). The same settings again queue
+/// nothing, the device inserts no word for them. Up to four changes can wait,
+/// beyond that the oldest is applied straight away. Only changes passed in here
+/// are known, the CFG_CHANGE payload itself is not decoded.
+/// @param config The settings.
+/// @return True if the settings were queued, false if they repeat the latest.
+bool SfeLSMFifoDecoder::queueConfig(const sfe_lsm_fifo_config_t &config)
+{
+    const sfe_lsm_fifo_config_t &latest =
+        (pendingCount > 0) ? pendingConfig[(pendingFirst + pendingCount - 1) & 0x03] : this->config;
+
+    if (config.accelScale == latest.accelScale && config.gyroScale == latest.gyroScale &&
+        config.accelBatchHz == latest.accelBatchHz && config.gyroBatchHz == latest.gyroBatchHz)
+        return false;
+
+    if (pendingCount == 4)
+        applyPendingConfig();
+
+    pendingConfig[(pendingFirst + pendingCount) & 0x03] = config;
+    pendingCount++;
+
+    return true;
+}
+
+/// @brief Returns the settings the next words will be decoded with.
+/// @return The full scales and batch rates.
+sfe_lsm_fifo_config_t SfeLSMFifoDecoder::getConfig()
+{
+    return config;
+}
+
+/// @brief Returns how many queued settings are still waiting for their
+/// CFG_CHANGE word.
+/// @return Number of queued settings, 0 - 4
+uint8_t SfeLSMFifoDecoder::getPendingConfigs()
+{
+    return pendingCount;
+}
+
+void SfeLSMFifoDecoder::applyPendingConfig()
+{
+    if (pendingCount == 0)
+        return;
+
+    setConfig(pendingConfig[pendingFirst]);
+    pendingFirst = (pendingFirst + 1) & 0x03;
+    pendingCount--;
+}
+
+/// @brief Registers the function called for every decoded word of the given
+/// type. Words of types without a handler are skipped without being converted.
+/// @param type The sample type to handle.
+/// @param handler The function to call, nullptr removes the handler.
+/// @param context Passed through to the handler unchanged.
+void SfeLSMFifoDecoder::setHandler(sfe_lsm_fifo_type_t type, sfe_lsm_fifo_handler_t handler, void *context)
+{
+    if (type >= LSM_FIFO_NUM_TYPES)
+        return;
+
+    handlers[type].handler = handler;
+    handlers[type].context = context;
+
+    // The generic sensor hub handler covers all four slots.
+    if (type == LSM_FIFO_SENSOR_HUB)
+    {
+        for (uint8_t slot = 0; slot < 4; slot++)
+            setSensorHubHandler(slot, handler, context);
+    }
+
+    // Words of this type were skipped until now, so the last sample is stale.
+    if (type == LSM_FIFO_ACCEL)
+    {
+        referenceValid[0] = false;
+        sampleStepValid[0] = false;
+    }
+    else if (type == LSM_FIFO_GYRO)
+    {
+        referenceValid[1] = false;
+        sampleStepValid[1] = false;
+    }
+}
+
+/// @brief Registers the function called for the FIFO words of one sensor hub
+/// slot, in place of the LSM_FIFO_SENSOR_HUB handler. This separates e.g. a
+/// magnetometer on slot 0 from a barometer on slot 1.
+/// @param slot The sensor hub slot, 0 - 3
+/// @param handler The function to call, nullptr removes the handler.
+/// @param context Passed through to the handler unchanged.
+void SfeLSMFifoDecoder::setSensorHubHandler(uint8_t slot, sfe_lsm_fifo_handler_t handler, void *context)
+{
+    if (slot > 3)
+        return;
+
+    handlers[kSensorHubHandler(slot)].handler = handler;
+    handlers[kSensorHubHandler(slot)].context = context;
+}
+
+/// @brief Sets the factor applied to a sensor hub slot's three little endian
+/// 16-bit words to fill the sample's vector, e.g. the sensitivity of an
+/// external magnetometer. The default of 1 passes the raw values through.
+/// @param slot The sensor hub slot, 0 - 3
+/// @param scale Units per LSB
+void SfeLSMFifoDecoder::setSensorHubScale(uint8_t slot, float scale)
+{
+    if (slot > 3)
+        return;
+
+    sensorHubScale[slot] = scale;
+}
+
+/// @brief Returns the factor set with setSensorHubScale().
+/// @param slot The sensor hub slot, 0 - 3
+/// @return Units per LSB, zero for a slot out of range.
+float SfeLSMFifoDecoder::getSensorHubScale(uint8_t slot)
+{
+    if (slot > 3)
+        return 0.0f;
+
+    return sensorHubScale[slot];
+}
+
+/// @brief Removes all registered handlers.
+void SfeLSMFifoDecoder::clearHandlers()
+{
+    for (uint8_t i = 0; i < LSM_FIFO_NUM_TYPES + 4; i++)
+    {
+        handlers[i].handler = nullptr;
+        handlers[i].context = nullptr;
+    }
+}
+
+/// @brief Forgets all state carried between words, call this whenever the
+/// FIFO has been flushed or words were lost.
+void SfeLSMFifoDecoder::reset()
+{
+    // Flushed CFG_CHANGE words won't come, the latest settings hold.
+    while (pendingCount > 0)
+        applyPendingConfig();
+
+    resetCompression();
+    resetTimeline();
+}
+
+void SfeLSMFifoDecoder::resetCompression()
+{
+    referenceValid[0] = false;
+    referenceValid[1] = false;
+}
+
+/// @brief Returns the number of accelerometer and gyroscope samples that are
+/// missing between the words decoded, handled or not, estimated from gaps in
+/// the tag counter steps and, for longer gaps, from the TIMESTAMP words.
+/// @return Samples dropped since the last resetDroppedSamples().
+uint32_t SfeLSMFifoDecoder::getDroppedSamples()
+{
+    return droppedSamples;
+}
+
+void SfeLSMFifoDecoder::resetDroppedSamples()
+{
+    droppedSamples = 0;
+}
+
+/// @brief Counts the samples of a sensor skipped before the samples of a word.
+/// @param channel 0 accelerometer, 1 gyroscope.
+/// @param convert The word's fifoConvert_t, which tells the samples' delays.
+void SfeLSMFifoDecoder::trackWord(uint8_t channel, uint8_t convert)
+{
+    switch (convert)
+    {
+    case kConvertNcT2:
+        trackSample(channel, 2);
+        break;
+    case kConvertNcT1:
+        trackSample(channel, 1);
+        break;
+    case kConvert2xc:
+        trackSample(channel, 2);
+        trackSample(channel, 1);
+        break;
+    case kConvert3xc:
+        trackSample(channel, 2);
+        trackSample(channel, 1);
+        trackSample(channel, 0);
+        break;
+    default:
+        trackSample(channel, 0);
+        break;
+    }
+}
+
+/// @brief Counts the samples of a sensor skipped since its previous sample.
+/// @param channel 0 accelerometer, 1 gyroscope.
+/// @param delay The sample's delay in batch periods.
+void SfeLSMFifoDecoder::trackSample(uint8_t channel, uint8_t delay)
+{
+    uint64_t step = tagStep - (uint64_t)delay * periodSteps[channel];
+
+    if (sampleStepValid[channel] && step > lastSampleStep[channel] + periodSteps[channel])
+        droppedSamples += (uint32_t)((step - lastSampleStep[channel]) / periodSteps[channel]) - 1;
+
+    lastSampleStep[channel] = step;
+    sampleStepValid[channel] = true;
+}
+
+void SfeLSMFifoDecoder::resetTimeline()
+{
+    sampleStepValid[0] = false;
+    sampleStepValid[1] = false;
+    tagStep = 0;
+    lastTagCounter = 0;
+    tagStarted = false;
+    baseTicks = 0;
+    baseStep = 0;
+    lastTicks = 0;
+    anchorValid = false;
+    baseInterpolated = false;
+    stepTicksQ16 = 0;
+}
+
+/// @brief Anchors the timeline to the time carried by a TIMESTAMP word.
+/// @param data The word's data bytes, the timestamp is in the first four.
+void SfeLSMFifoDecoder::updateTimeline(const uint8_t *data)
+{
+    uint32_t ticks = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+                     ((uint32_t)data[3] << 24);
+    uint64_t extended = (lastTicks & 0xFFFFFFFF00000000ULL) | ticks;
+
+    // The device counter is 32 bits wide and wraps after roughly 26 hours.
+    if (anchorValid && extended < lastTicks)
+        extended += 0x100000000ULL;
+
+    lastTicks = extended;
+
+    if (!anchorValid)
+    {
+        baseTicks = extended;
+        baseStep = tagStep;
+        stepTicksQ16 = nominalStepTicksQ16;
+        anchorValid = true;
+        return;
+    }
+
+    // The first TIMESTAMP word after a batch rate change starts the new fit.
+    if (baseInterpolated)
+    {
+        baseTicks = extended;
+        baseStep = tagStep;
+        baseInterpolated = false;
+        return;
+    }
+
+    uint64_t steps = tagStep - baseStep;
+    int64_t error = (int64_t)((extended - baseTicks) << 16) - (int64_t)(steps * stepTicksQ16);
+
+    // More than three ticks off the fitted line means steps went missing, e.g.
+    // the FIFO overran, so start a new fit from here.
+    if (error > (3 << 16) || error < -(3 << 16))
+    {
+        // The tag counter only tells gaps of up to three steps apart, the
+        // timestamp tells how many steps were really lost.
+        if (error > 0 && stepTicksQ16 > 0)
+            tagStep += ((uint64_t)error + stepTicksQ16 / 2) / stepTicksQ16;
+
+        baseTicks = extended;
+        baseStep = tagStep;
+        return;
+    }
+
+    if (steps > 0)
+        stepTicksQ16 = ((extended - baseTicks) << 16) / steps;
+}
+
+/// @brief Sets the time of a sample from its step on the timeline.
+/// @param sample The sample, its delay is taken into account.
+/// @param periodSteps Steps per batch period of the sample's sensor.
+void SfeLSMFifoDecoder::stampSample(sfe_lsm_fifo_sample_t &sample, uint8_t periodSteps)
+{
+    sample.timeValid = anchorValid;
+
+    if (!anchorValid)
+    {
+        sample.time = 0;
+        return;
+    }
+
+    int64_t steps = (int64_t)(tagStep - baseStep) - (int64_t)sample.delay * periodSteps;
+    uint64_t ticksQ16 = (baseTicks << 16) + (uint64_t)(steps * (int64_t)stepTicksQ16);
+
+    sample.time = ((ticksQ16 >> 16) * tickPeriodPs + (((ticksQ16 & 0xFFFF) * tickPeriodPs) >> 16)) / 1000;
+}
+
+/// @brief Walks an array of raw FIFO words, converts each one according to its
+/// tag and passes it to the handler registered for its type.
+/// @param words The FIFO words as read from the device.
+/// @param count The number of words.
+/// @return The number of samples passed to a handler.
+uint16_t SfeLSMFifoDecoder::decode(const sfe_lsm_fifo_word_t *words, uint16_t count)
+{
+    sfe_lsm_fifo_sample_t sample;
+    uint16_t dispatched = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const sfe_lsm_fifo_word_t &word = words[i];
+        const uint8_t sensor = word.tag >> 3;
+        const uint8_t tagCounter = (word.tag >> 1) & 0x03;
+        const fifoTagInfo_t &info = kTagTable[sensor];
+        const handlerSlot_t &slot = handlers[info.handler];
+
+        // Every word moves the timeline, whether it is handled or not.
+        if (tagStarted)
+            tagStep += (uint8_t)(tagCounter - lastTagCounter) & 0x03;
+        lastTagCounter = tagCounter;
+        tagStarted = true;
+
+        if (info.type == LSM_FIFO_TIMESTAMP)
+            updateTimeline(word.data);
+        else if (info.type == LSM_FIFO_CFG_CHANGE)
+            applyPendingConfig();
+        else if (info.type == LSM_FIFO_ACCEL || info.type == LSM_FIFO_GYRO)
+            trackWord((info.type == LSM_FIFO_ACCEL) ? 0 : 1, info.convert);
+
+        if (slot.handler == nullptr)
+            continue;
+
+        const uint8_t *data = word.data;
+
+        sample.type = (sfe_lsm_fifo_type_t)info.type;
+        sample.tag = sensor;
+        sample.tagCounter = tagCounter;
+        sample.slot = info.slot;
+        sample.delay = 0;
+        sample.bytes = data;
+        sample.raw[0] = (int16_t)((uint16_t)data[0] | ((uint16_t)data[1] << 8));
+        sample.raw[1] = (int16_t)((uint16_t)data[2] | ((uint16_t)data[3] << 8));
+        sample.raw[2] = (int16_t)((uint16_t)data[4] | ((uint16_t)data[5] << 8));
+
+        if (info.convert >= kConvertNcT2)
+        {
+            dispatched += decompress(word, info.convert, sample, slot);
+            continue;
+        }
+
+        switch (info.convert)
+        {
+        case kConvertAccel:
+            reference[0][0] = sample.raw[0];
+            reference[0][1] = sample.raw[1];
+            reference[0][2] = sample.raw[2];
+            referenceValid[0] = true;
+            sample.vector.xData = sample.raw[0] * accelSensitivity;
+            sample.vector.yData = sample.raw[1] * accelSensitivity;
+            sample.vector.zData = sample.raw[2] * accelSensitivity;
+            break;
+        case kConvertGyro:
+            reference[1][0] = sample.raw[0];
+            reference[1][1] = sample.raw[1];
+            reference[1][2] = sample.raw[2];
+            referenceValid[1] = true;
+            sample.vector.xData = sample.raw[0] * gyroSensitivity;
+            sample.vector.yData = sample.raw[1] * gyroSensitivity;
+            sample.vector.zData = sample.raw[2] * gyroSensitivity;
+            break;
+        case kConvertTemp:
+            sample.temperature = lsm6dsv16x_from_lsb_to_celsius(sample.raw[0]);
+            break;
+        case kConvertTimestamp:
+            sample.timestamp = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+                               ((uint32_t)data[3] << 24);
+            break;
+        case kConvertStepCounter:
+            sample.stepCounter.steps = (uint16_t)sample.raw[0];
+            sample.stepCounter.timestamp = (uint32_t)data[2] | ((uint32_t)data[3] << 8) | ((uint32_t)data[4] << 16) |
+                                           ((uint32_t)data[5] << 24);
+            break;
+        case kConvertGravity:
+            sample.vector.xData = lsm6dsv16x_from_sflp_to_mg(sample.raw[0]);
+            sample.vector.yData = lsm6dsv16x_from_sflp_to_mg(sample.raw[1]);
+            sample.vector.zData = lsm6dsv16x_from_sflp_to_mg(sample.raw[2]);
+            break;
+        case kConvertGameRotation: {
+            // x, y and z of a unit quaternion, w follows from them
+            float sumSquares = 0.0f;
+
+            for (uint8_t axis = 0; axis < 3; axis++)
+            {
+                sample.quaternion[axis] = halfToFloat((uint16_t)sample.raw[axis]);
+                sumSquares += sample.quaternion[axis] * sample.quaternion[axis];
+            }
+
+            if (sumSquares > 1.0f)
+            {
+                float norm = sqrtf(sumSquares);
+                sample.quaternion[0] /= norm;
+                sample.quaternion[1] /= norm;
+                sample.quaternion[2] /= norm;
+                sumSquares = 1.0f;
+            }
+
+            sample.quaternion[3] = sqrtf(1.0f - sumSquares);
+            break;
+        }
+        case kConvertGyroBias:
+            sample.vector.xData = lsm6dsv16x_from_fs125_to_mdps(sample.raw[0]);
+            sample.vector.yData = lsm6dsv16x_from_fs125_to_mdps(sample.raw[1]);
+            sample.vector.zData = lsm6dsv16x_from_fs125_to_mdps(sample.raw[2]);
+            break;
+        case kConvertMlcResult:
+            sample.mlcResult.value = data[0];
+            sample.mlcResult.index = data[1];
+            sample.mlcResult.timestamp = (uint32_t)data[2] | ((uint32_t)data[3] << 8) | ((uint32_t)data[4] << 16) |
+                                         ((uint32_t)data[5] << 24);
+            break;
+        case kConvertMlcFeature:
+            sample.mlcFeature.value = halfToFloat((uint16_t)sample.raw[0]);
+            sample.mlcFeature.id = (uint16_t)sample.raw[1];
+            break;
+        case kConvertSensorHub:
+            sample.vector.xData = sample.raw[0] * sensorHubScale[info.slot];
+            sample.vector.yData = sample.raw[1] * sensorHubScale[info.slot];
+            sample.vector.zData = sample.raw[2] * sensorHubScale[info.slot];
+            break;
+        default:
+            break;
+        }
+
+        stampSample(sample, 1);
+        slot.handler(&sample, slot.context);
+        dispatched++;
+    }
+
+    return dispatched;
+}
+
+/// @brief Reconstructs the samples held in one compressed accelerometer or
+/// gyroscope word and passes each of them to the handler, oldest first.
+/// @param word The compressed FIFO word.
+/// @param convert The word's compression format.
+/// @param sample Sample already filled with the word's type, tag and raw words.
+/// @param slot The handler for the word's type.
+/// @return The number of samples passed to the handler.
+uint16_t SfeLSMFifoDecoder::decompress(const sfe_lsm_fifo_word_t &word, uint8_t convert,
+                                       sfe_lsm_fifo_sample_t &sample, const handlerSlot_t &slot)
+{
+    const uint8_t channel = (sample.type == LSM_FIFO_ACCEL) ? 0 : 1;
+    const float sensitivity = (channel == 0) ? accelSensitivity : gyroSensitivity;
+    int16_t *last = reference[channel];
+    int16_t delta[3][3];
+    uint8_t numSamples;
+
+    switch (convert)
+    {
+    case kConvertNcT2:
+    case kConvertNcT1:
+        // Uncompressed, the raw words already hold the sample.
+        last[0] = sample.raw[0];
+        last[1] = sample.raw[1];
+        last[2] = sample.raw[2];
+        referenceValid[channel] = true;
+
+        sample.delay = (convert == kConvertNcT2) ? 2 : 1;
+        stampSample(sample, periodSteps[channel]);
+        sample.vector.xData = sample.raw[0] * sensitivity;
+        sample.vector.yData = sample.raw[1] * sensitivity;
+        sample.vector.zData = sample.raw[2] * sensitivity;
+        slot.handler(&sample, slot.context);
+        return 1;
+
+    case kConvert2xc:
+        // Six signed bytes, x/y/z at t-2 followed by x/y/z at t-1
+        for (uint8_t i = 0; i < 2; i++)
+            for (uint8_t axis = 0; axis < 3; axis++)
+                delta[i][axis] = (int8_t)word.data[3 * i + axis];
+        numSamples = 2;
+        break;
+
+    case kConvert3xc:
+        // Three little endian words, one per sample at t-2, t-1 and t, each
+        // holding x/y/z as signed 5-bit values in bits 4:0, 9:5 and 14:10.
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            uint16_t packed = (uint16_t)word.data[2 * i] | ((uint16_t)word.data[2 * i + 1] << 8);
+
+            for (uint8_t axis = 0; axis < 3; axis++)
+            {
+                uint8_t value = (packed >> (5 * axis)) & 0x1F;
+                delta[i][axis] = (value & 0x10) ? (int16_t)value - 32 : (int16_t)value;
+            }
+        }
+        numSamples = 3;
+        break;
+
+    default:
+        return 0;
+    }
+
+    // Deltas are meaningless without the sample they apply to.
+    if (!referenceValid[channel])
+        return 0;
+
+    for (uint8_t i = 0; i < numSamples; i++)
+    {
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            last[axis] = (int16_t)(uint16_t)((uint16_t)last[axis] + (uint16_t)delta[i][axis]);
+            sample.raw[axis] = last[axis];
+        }
+
+        sample.delay = 2 - i;
+        stampSample(sample, periodSteps[channel]);
+        sample.vector.xData = sample.raw[0] * sensitivity;
+        sample.vector.yData = sample.raw[1] * sensitivity;
+        sample.vector.zData = sample.raw[2] * sensitivity;
+        slot.handler(&sample, slot.context);
+    }
+
+    return numSamples;
+}
+
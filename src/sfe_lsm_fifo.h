@@ -0,0 +1,190 @@
+#pragma once
+
+// FIFO word decoding for the LSM6DSV16X. Nothing in here touches the bus or
+// the Arduino core, so the same decoder can be built on a host to replay
+// captured FIFO data.
+
+#include "st_src/lsm6dsv16x_reg.h"
+
+struct sfe_lsm_raw_data_t
+{
+    int16_t xData;
+    int16_t yData;
+    int16_t zData;
+};
+
+struct sfe_lsm_data_t
+{
+    float xData;
+    float yData;
+    float zData;
+};
+
+// One FIFO word exactly as it is read from FIFO_DATA_OUT_TAG: the tag byte
+// (sensor in bits 7:3, tag counter in bits 2:1) followed by six data bytes.
+struct sfe_lsm_fifo_word_t
+{
+    uint8_t tag;
+    uint8_t data[6];
+};
+
+// What a decoded FIFO word carries. Several FIFO tags can map onto one type,
+// e.g. all four sensor hub slots are LSM_FIFO_SENSOR_HUB with a slot number.
+typedef enum
+{
+    LSM_FIFO_UNKNOWN = 0x00, // Reserved or not yet decoded tags
+    LSM_FIFO_ACCEL,
+    LSM_FIFO_GYRO,
+    LSM_FIFO_TEMP,
+    LSM_FIFO_TIMESTAMP,
+    LSM_FIFO_CFG_CHANGE,
+    LSM_FIFO_SENSOR_HUB,
+    LSM_FIFO_SENSOR_HUB_NACK,
+    LSM_FIFO_STEP_COUNTER,
+    LSM_FIFO_GAME_ROTATION,
+    LSM_FIFO_GYRO_BIAS,
+    LSM_FIFO_GRAVITY,
+    LSM_FIFO_MLC_RESULT,
+    LSM_FIFO_MLC_FILTER,
+    LSM_FIFO_MLC_FEATURE,
+    LSM_FIFO_ACCEL_DUAL,
+    LSM_FIFO_GYRO_EIS,
+    LSM_FIFO_NUM_TYPES
+} sfe_lsm_fifo_type_t;
+
+struct sfe_lsm_fifo_sample_t
+{
+    sfe_lsm_fifo_type_t type;
+    uint8_t tag;          // FIFO tag sensor field, see lsm6dsv16x_fifo_out_raw_t
+    uint8_t tagCounter;   // FIFO tag counter, 0 - 3
+    uint8_t slot;         // Sensor hub slot 0 - 3, zero for all other types
+    uint8_t delay;        // Batch periods the sample precedes its tag counter, set for compressed words
+    int16_t raw[3];       // The six data bytes as little endian 16-bit words
+    const uint8_t *bytes; // The six data bytes, only valid during the handler call
+    bool timeValid;       // False until the first TIMESTAMP word has been decoded
+    uint64_t time;        // Sample time in nanoseconds on the device's 64-bit timeline
+
+    // Converted value, which member is valid depends on type.
+    union {
+        sfe_lsm_data_t vector; // Accel and gravity in mg, gyro and gyro bias in mdps, sensor hub raw * scale
+        float quaternion[4];   // Game rotation vector as x, y, z, w
+        float temperature;     // Degrees C
+        uint32_t timestamp;    // Timestamp ticks, 21.75us nominal
+        struct
+        {
+            uint16_t steps;
+            uint32_t timestamp;
+        } stepCounter;
+        struct
+        {
+            uint8_t value;      // The decision tree's output, as in MLCx_SRC
+            uint8_t index;      // Decision tree 0 - 3
+            uint32_t timestamp; // Timestamp ticks of the result
+        } mlcResult;
+        struct
+        {
+            float value; // Half precision value of the MLC filter or feature
+            uint16_t id; // Which filter or feature, in the order of the MLC configuration
+        } mlcFeature;
+    };
+};
+
+// The settings FIFO words are converted with. A change made while the FIFO is
+// batching only applies from the CFG_CHANGE word the device inserts for it.
+struct sfe_lsm_fifo_config_t
+{
+    lsm6dsv16x_xl_full_scale_t accelScale;
+    lsm6dsv16x_gy_full_scale_t gyroScale;
+    float accelBatchHz; // Zero if not batched
+    float gyroBatchHz;  // Zero if not batched
+};
+
+typedef void (*sfe_lsm_fifo_handler_t)(const sfe_lsm_fifo_sample_t *sample, void *context);
+
+class SfeLSMFifoDecoder
+{
+  public:
+    SfeLSMFifoDecoder();
+
+    void setAccelFullScale(lsm6dsv16x_xl_full_scale_t scale);
+    void setGyroFullScale(lsm6dsv16x_gy_full_scale_t scale);
+
+    void setHandler(sfe_lsm_fifo_type_t type, sfe_lsm_fifo_handler_t handler, void *context = nullptr);
+    void setSensorHubHandler(uint8_t slot, sfe_lsm_fifo_handler_t handler, void *context = nullptr);
+    void setSensorHubScale(uint8_t slot, float scale);
+    float getSensorHubScale(uint8_t slot);
+    void clearHandlers();
+
+    void setBatchRates(float accelHz, float gyroHz);
+    void setOdrCalibration(int8_t freqFine);
+    int8_t getOdrCalibration();
+
+    void setConfig(const sfe_lsm_fifo_config_t &config);
+    bool queueConfig(const sfe_lsm_fifo_config_t &config);
+    sfe_lsm_fifo_config_t getConfig();
+    uint8_t getPendingConfigs();
+
+    uint16_t decode(const sfe_lsm_fifo_word_t *words, uint16_t count);
+    void reset();
+
+    uint32_t getDroppedSamples();
+    void resetDroppedSamples();
+
+  private:
+    struct handlerSlot_t
+    {
+        sfe_lsm_fifo_handler_t handler;
+        void *context;
+    };
+
+    // One handler per type, followed by one per sensor hub slot
+    handlerSlot_t handlers[LSM_FIFO_NUM_TYPES + 4];
+    float sensorHubScale[4];
+
+    // Compressed words are deltas against the last accelerometer (0) and
+    // gyroscope (1) sample, valid once an uncompressed word has been seen.
+    void resetCompression();
+    uint16_t decompress(const sfe_lsm_fifo_word_t &word, uint8_t convert, sfe_lsm_fifo_sample_t &sample,
+                        const handlerSlot_t &slot);
+    int16_t reference[2][3];
+    bool referenceValid[2];
+
+    float accelSensitivity; // mg per LSB
+    float gyroSensitivity;  // mdps per LSB
+    sfe_lsm_fifo_config_t config;
+
+    // Settings waiting for their CFG_CHANGE word, oldest first
+    void applyPendingConfig();
+    sfe_lsm_fifo_config_t pendingConfig[4];
+    uint8_t pendingFirst;
+    uint8_t pendingCount;
+
+    // Timeline. A step is one tag counter increment, i.e. one period of the
+    // fastest batched sensor. Steps and timestamp ticks come from the same
+    // oscillator, so ticks per step is a constant that is fitted over all
+    // TIMESTAMP words since the base anchor, giving sub-tick sample times.
+    void resetTimeline();
+    void updateTimeline(const uint8_t *data);
+    void stampSample(sfe_lsm_fifo_sample_t &sample, uint8_t periodSteps);
+    uint64_t tagStep;
+    uint8_t lastTagCounter;
+    bool tagStarted;
+    uint64_t baseTicks;
+    uint64_t baseStep;
+    uint64_t lastTicks;
+    bool anchorValid;
+    bool baseInterpolated; // The base was moved by a batch rate change, not set by a TIMESTAMP word
+    uint64_t stepTicksQ16;
+    uint64_t nominalStepTicksQ16;
+    uint32_t tickPeriodPs;
+    int8_t odrCalibration;
+    uint8_t periodSteps[2]; // Steps per batch period of the accelerometer (0) and gyroscope (1)
+
+    // Gap detection on the accelerometer (0) and gyroscope (1) samples
+    void trackWord(uint8_t channel, uint8_t convert);
+    void trackSample(uint8_t channel, uint8_t delay);
+    uint64_t lastSampleStep[2];
+    bool sampleStepValid[2];
+    uint32_t droppedSamples;
+};
+
@@ -0,0 +1,329 @@
+#include "sfe_lsm_framer.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// CRC-16/CCITT-FALSE, polynomial 0x1021, four bits at a time.
+static const uint16_t kCrcTable[16] = {0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+                                       0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+static uint16_t crcUpdate(uint16_t crc, uint8_t value)
+{
+    crc = (uint16_t)(crc << 4) ^ kCrcTable[(crc >> 12) ^ (value >> 4)];
+    crc = (uint16_t)(crc << 4) ^ kCrcTable[(crc >> 12) ^ (value & 0x0F)];
+    return crc;
+}
+
+#ifdef ARDUINO
+static size_t printSink(const uint8_t *data, size_t length, void *context)
+{
+    return ((Print *)context)->write(data, length);
+}
+#endif
+
+SfeLSMFifoFramer::SfeLSMFifoFramer()
+    : sink{nullptr}, context{nullptr}, sequence{0}, crc{0}, framesWritten{0}, writeErrors{0}, blockError{false},
+      blockLength{1}
+{
+}
+
+/// @brief Starts the passthrough: the first frame carries the decoder's
+/// current settings so the host converts the words that follow correctly.
+/// @param sink Receives the encoded bytes.
+/// @param context Passed through to the sink unchanged.
+/// @param decoder The decoder whose settings the words are taken with.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoFramer::begin(sfe_lsm_log_sink_t sink, void *context, SfeLSMFifoDecoder &decoder)
+{
+    this->sink = sink;
+    this->context = context;
+    sequence = 0;
+    framesWritten = 0;
+    writeErrors = 0;
+
+    if (sink == nullptr)
+        return false;
+
+    // A leading delimiter ends whatever a receiver picked up before, so the
+    // settings frame is not lost to it.
+    const uint8_t delimiter = 0;
+
+    if (sink(&delimiter, 1, context) != 1)
+        writeErrors++;
+
+    return writeConfig(decoder.getConfig(), decoder.getOdrCalibration());
+}
+
+#ifdef ARDUINO
+/// @brief Starts the passthrough to e.g. Serial.
+/// @param out Receives the encoded bytes.
+/// @param decoder The decoder whose settings the words are taken with.
+/// @return True if all bytes were written.
+bool SfeLSMFifoFramer::begin(Print &out, SfeLSMFifoDecoder &decoder)
+{
+    return begin(printSink, &out, decoder);
+}
+#endif
+
+/// @brief Sends FIFO words exactly as they were read from the device, split
+/// into frames of up to kLSMFrameMaxWords words.
+/// @param words The FIFO words.
+/// @param count The number of words.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoFramer::writeWords(const sfe_lsm_fifo_word_t *words, uint16_t count)
+{
+    bool success = true;
+
+    while (count > 0)
+    {
+        uint16_t frameWords = (count > kLSMFrameMaxWords) ? kLSMFrameMaxWords : count;
+
+        success &= writeFrame(LSM_FRAME_FIFO_WORDS, (const uint8_t *)words, frameWords * sizeof(sfe_lsm_fifo_word_t));
+        words += frameWords;
+        count -= frameWords;
+    }
+
+    return success;
+}
+
+/// @brief Sends new decoder settings, e.g. after a full scale change.
+/// @param config The full scales and batch rates.
+/// @param odrCalibration The ODR calibration, see SfeLSMFifoDecoder::setOdrCalibration()
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoFramer::writeConfig(const sfe_lsm_fifo_config_t &config, int8_t odrCalibration)
+{
+    uint8_t payload[kLSMLogConfigSize];
+
+    SfeLSMFifoLogWriter::packConfig(config, odrCalibration, payload);
+
+    return writeFrame(LSM_FRAME_CONFIG, payload, sizeof(payload));
+}
+
+/// @brief Returns the number of frames sent since begin().
+/// @return Frames written
+uint32_t SfeLSMFifoFramer::getFramesWritten()
+{
+    return framesWritten;
+}
+
+/// @brief Returns the number of frames the sink did not take in full, the host
+/// sees each of them as a bad frame.
+/// @return Failed frames since begin()
+uint32_t SfeLSMFifoFramer::getWriteErrors()
+{
+    return writeErrors;
+}
+
+bool SfeLSMFifoFramer::writeFrame(uint8_t type, const uint8_t *payload, uint16_t length)
+{
+    uint8_t header[3];
+    uint8_t trailer[2];
+
+    if (sink == nullptr)
+        return false;
+
+    header[0] = type;
+    header[1] = (uint8_t)sequence;
+    header[2] = (uint8_t)(sequence >> 8);
+    sequence++;
+
+    crc = 0xFFFF;
+    blockError = false;
+    blockLength = 1;
+
+    encode(header, sizeof(header));
+    encode(payload, length);
+
+    trailer[0] = (uint8_t)crc;
+    trailer[1] = (uint8_t)(crc >> 8);
+    encode(trailer, sizeof(trailer));
+
+    flushBlock(true);
+    framesWritten++;
+
+    if (blockError)
+    {
+        writeErrors++;
+        return false;
+    }
+
+    return true;
+}
+
+void SfeLSMFifoFramer::encode(const uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc = crcUpdate(crc, data[i]);
+        encodeByte(data[i]);
+    }
+}
+
+void SfeLSMFifoFramer::encodeByte(uint8_t value)
+{
+    if (value == 0)
+    {
+        // The zero is implied by the code byte.
+        flushBlock(false);
+        return;
+    }
+
+    block[blockLength++] = value;
+
+    // A full block has no implied zero, the next one just carries on.
+    if (blockLength == sizeof(block))
+        flushBlock(false);
+}
+
+/// @brief Writes the COBS block built so far and starts a new one.
+/// @param delimiter True to end the frame with the zero byte.
+void SfeLSMFifoFramer::flushBlock(bool delimiter)
+{
+    block[0] = blockLength;
+
+    if (delimiter)
+        block[blockLength++] = 0;
+
+    if (sink(block, blockLength, context) != blockLength)
+        blockError = true;
+
+    blockLength = 1;
+}
+
+SfeLSMFifoDeframer::SfeLSMFifoDeframer() : handler{nullptr}, context{nullptr}
+{
+    reset();
+    frames = 0;
+    badFrames = 0;
+    lostFrames = 0;
+}
+
+/// @brief Registers the function called for every frame that arrives intact.
+/// @param handler The function to call.
+/// @param context Passed through to the handler unchanged.
+void SfeLSMFifoDeframer::setHandler(sfe_lsm_frame_handler_t handler, void *context)
+{
+    this->handler = handler;
+    this->context = context;
+}
+
+/// @brief Feeds received bytes in, in any chunk size. Frames are checked and
+/// passed to the handler as soon as their delimiter arrives.
+/// @param data The received bytes.
+/// @param length The number of bytes.
+void SfeLSMFifoDeframer::push(const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t value = data[i];
+
+        if (value == 0)
+        {
+            endFrame();
+            continue;
+        }
+
+        if (codeRemaining == 0)
+        {
+            // A code byte, the block before it ended in a zero unless it was full.
+            if (codeZero)
+            {
+                if (frameLength < sizeof(frame))
+                    frame[frameLength++] = 0;
+                else
+                    overflow = true;
+            }
+
+            codeRemaining = value - 1;
+            codeZero = (value != 0xFF);
+            continue;
+        }
+
+        if (frameLength < sizeof(frame))
+            frame[frameLength++] = value;
+        else
+            overflow = true;
+
+        codeRemaining--;
+    }
+}
+
+/// @brief Drops a partly received frame and forgets the sequence number, e.g.
+/// when the port was reopened.
+void SfeLSMFifoDeframer::reset()
+{
+    frameLength = 0;
+    codeRemaining = 0;
+    codeZero = false;
+    overflow = false;
+    sequenceValid = false;
+    nextSequence = 0;
+}
+
+/// @brief Returns the number of frames passed to the handler.
+/// @return Intact frames
+uint32_t SfeLSMFifoDeframer::getFrames()
+{
+    return frames;
+}
+
+/// @brief Returns the number of frames dropped for a bad CRC, a bad encoding or
+/// their size.
+/// @return Bad frames
+uint32_t SfeLSMFifoDeframer::getBadFrames()
+{
+    return badFrames;
+}
+
+/// @brief Returns the number of frames missing from the sequence numbers,
+/// including the bad ones. Frames lost just before the sender restarted are
+/// not counted.
+/// @return Lost frames
+uint32_t SfeLSMFifoDeframer::getLostFrames()
+{
+    return lostFrames;
+}
+
+void SfeLSMFifoDeframer::endFrame()
+{
+    bool valid = !overflow && codeRemaining == 0 && frameLength >= 5;
+
+    if (valid)
+    {
+        uint16_t crc = 0xFFFF;
+
+        for (uint16_t i = 0; i < frameLength - 2; i++)
+            crc = crcUpdate(crc, frame[i]);
+
+        valid = (crc == ((uint16_t)frame[frameLength - 2] | ((uint16_t)frame[frameLength - 1] << 8)));
+    }
+
+    // Back to back delimiters are not frames.
+    if (!valid && (frameLength > 0 || overflow))
+        badFrames++;
+
+    if (valid)
+    {
+        uint16_t sequence = (uint16_t)frame[1] | ((uint16_t)frame[2] << 8);
+
+        // A settings frame numbered 0 is the framer starting over, e.g. after
+        // the board was reset, not a jump over the frames in between.
+        bool restart = (frame[0] == LSM_FRAME_CONFIG && sequence == 0);
+
+        if (sequenceValid && !restart)
+            lostFrames += (uint16_t)(sequence - nextSequence);
+
+        nextSequence = sequence + 1;
+        sequenceValid = true;
+        frames++;
+
+        if (handler != nullptr)
+            handler(frame[0], sequence, &frame[3], frameLength - 5, context);
+    }
+
+    frameLength = 0;
+    codeRemaining = 0;
+    codeZero = false;
+    overflow = false;
+}
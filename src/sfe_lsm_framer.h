@@ -0,0 +1,101 @@
+#pragma once
+
+// Framed passthrough of raw FIFO words, e.g. to a host over a UART or USB
+// serial port at full output data rate. The words are sent as read from the
+// device, without any conversion on the board; the host decodes them with
+// SfeLSMFifoDeframer and SfeLSMFifoDecoder. See extras/fifo_frame_decode.
+//
+// Frame, before COBS encoding, all fields little endian:
+//     0  uint8    Frame type, sfe_lsm_frame_type_t
+//     1  uint16   Sequence number, one more than the previous frame's
+//     3  ...      Payload
+//     n  uint16   CRC-16/CCITT-FALSE of the type, sequence and payload
+//
+// Every frame is COBS encoded and followed by a zero byte, so a receiver
+// finds the next frame boundary after any corruption or a late start.
+//
+//   LSM_FRAME_FIFO_WORDS  Payload is up to kLSMFrameMaxWords FIFO words, 7 bytes each
+//   LSM_FRAME_CONFIG      Decoder settings, laid out as a LSM_LOG_CONFIG record
+
+#include "sfe_lsm_fifo.h"
+#include "sfe_lsm_log.h"
+
+#define kLSMFrameMaxWords 64
+#define kLSMFrameMaxPayload (kLSMFrameMaxWords * 7)
+#define kLSMFrameMaxSize (kLSMFrameMaxPayload + 5)
+
+typedef enum
+{
+    LSM_FRAME_FIFO_WORDS = 0x01,
+    LSM_FRAME_CONFIG
+} sfe_lsm_frame_type_t;
+
+class SfeLSMFifoFramer
+{
+  public:
+    SfeLSMFifoFramer();
+
+    bool begin(sfe_lsm_log_sink_t sink, void *context, SfeLSMFifoDecoder &decoder);
+#ifdef ARDUINO
+    bool begin(Print &out, SfeLSMFifoDecoder &decoder);
+#endif
+    bool writeWords(const sfe_lsm_fifo_word_t *words, uint16_t count);
+    bool writeConfig(const sfe_lsm_fifo_config_t &config, int8_t odrCalibration);
+
+    uint32_t getFramesWritten();
+    uint32_t getWriteErrors();
+
+  private:
+    bool writeFrame(uint8_t type, const uint8_t *payload, uint16_t length);
+    void encode(const uint8_t *data, uint16_t length);
+    void encodeByte(uint8_t value);
+    void flushBlock(bool delimiter);
+
+    sfe_lsm_log_sink_t sink;
+    void *context;
+    uint16_t sequence;
+    uint16_t crc;
+    uint32_t framesWritten;
+    uint32_t writeErrors;
+    bool blockError;
+
+    // COBS block being built, the code byte followed by up to 254 data bytes
+    uint8_t block[255];
+    uint8_t blockLength;
+};
+
+// Called for every frame that arrives intact.
+typedef void (*sfe_lsm_frame_handler_t)(uint8_t type, uint16_t sequence, const uint8_t *payload, uint16_t length,
+                                        void *context);
+
+class SfeLSMFifoDeframer
+{
+  public:
+    SfeLSMFifoDeframer();
+
+    void setHandler(sfe_lsm_frame_handler_t handler, void *context = nullptr);
+    void push(const uint8_t *data, size_t length);
+    void reset();
+
+    uint32_t getFrames();
+    uint32_t getBadFrames();
+    uint32_t getLostFrames();
+
+  private:
+    void endFrame();
+
+    sfe_lsm_frame_handler_t handler;
+    void *context;
+
+    uint8_t frame[kLSMFrameMaxSize];
+    uint16_t frameLength;
+    uint8_t codeRemaining; // Data bytes left in the current COBS block
+    bool codeZero;         // The current block ends in a zero, unless it is the last one
+    bool overflow;
+
+    bool sequenceValid;
+    uint16_t nextSequence;
+    uint32_t frames;
+    uint32_t badFrames;
+    uint32_t lostFrames;
+};
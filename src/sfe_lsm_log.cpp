@@ -0,0 +1,396 @@
+#include "sfe_lsm_log.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+static const uint8_t kLogMagic[4] = {'L', 'S', 'M', 'F'};
+
+static void putLE16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static void putLE32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)value;
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint16_t getLE16(const uint8_t *buffer)
+{
+    return (uint16_t)buffer[0] | ((uint16_t)buffer[1] << 8);
+}
+
+static uint32_t getLE32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) |
+           ((uint32_t)buffer[3] << 24);
+}
+
+#ifdef ARDUINO
+static size_t printSink(const uint8_t *data, size_t length, void *context)
+{
+    return ((Print *)context)->write(data, length);
+}
+#endif
+
+SfeLSMFifoLogWriter::SfeLSMFifoLogWriter() : sink{nullptr}, context{nullptr}, bytesWritten{0}, writeErrors{0}
+{
+}
+
+/// @brief Starts a log: writes the file header followed by the decoder's
+/// current settings and the sensor hub scales that are not 1.
+/// @param sink Receives the log bytes.
+/// @param context Passed through to the sink unchanged.
+/// @param decoder The decoder whose settings the logged words are taken with.
+/// @param timeMs Time of the first record.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoLogWriter::begin(sfe_lsm_log_sink_t sink, void *context, SfeLSMFifoDecoder &decoder, uint32_t timeMs)
+{
+    uint8_t header[kLSMLogHeaderSize] = {0};
+
+    this->sink = sink;
+    this->context = context;
+    bytesWritten = 0;
+    writeErrors = 0;
+
+    if (sink == nullptr)
+        return false;
+
+    memcpy(header, kLogMagic, sizeof(kLogMagic));
+    putLE16(&header[4], kLSMLogVersion);
+    header[6] = kLSMLogRecordHeaderSize;
+    header[7] = sizeof(sfe_lsm_fifo_word_t);
+    header[8] = LSM6DSV16X_ID;
+
+    if (!put(header, sizeof(header)))
+        return false;
+
+    if (!writeConfig(decoder.getConfig(), decoder.getOdrCalibration(), false, timeMs))
+        return false;
+
+    for (uint8_t slot = 0; slot < 4; slot++)
+    {
+        float scale = decoder.getSensorHubScale(slot);
+
+        if (scale != 1.0f && !writeHubScale(slot, scale, timeMs))
+            return false;
+    }
+
+    return true;
+}
+
+#ifdef ARDUINO
+/// @brief Starts a log written to e.g. an SD card File or a Serial port.
+/// @param out Receives the log bytes.
+/// @param decoder The decoder whose settings the logged words are taken with.
+/// @param timeMs Time of the first record.
+/// @return True if all bytes were written.
+bool SfeLSMFifoLogWriter::begin(Print &out, SfeLSMFifoDecoder &decoder, uint32_t timeMs)
+{
+    return begin(printSink, &out, decoder, timeMs);
+}
+#endif
+
+/// @brief Logs FIFO words exactly as they were read from the device.
+/// @param words The FIFO words.
+/// @param count The number of words, at most 9362 per call.
+/// @param timeMs Time the words were read.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoLogWriter::writeWords(const sfe_lsm_fifo_word_t *words, uint16_t count, uint32_t timeMs)
+{
+    if ((uint32_t)count * sizeof(sfe_lsm_fifo_word_t) > 0xFFFF)
+        return false;
+
+    return writeRecord(LSM_LOG_FIFO_WORDS, (const uint8_t *)words, count * sizeof(sfe_lsm_fifo_word_t), timeMs);
+}
+
+/// @brief Logs new decoder settings.
+/// @param config The full scales and batch rates.
+/// @param odrCalibration The ODR calibration, see SfeLSMFifoDecoder::setOdrCalibration()
+/// @param queued True if the settings apply from the next CFG_CHANGE word, as
+/// with SfeLSMFifoDecoder::queueConfig(), false if they apply straight away.
+/// @param timeMs Time of the change.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoLogWriter::writeConfig(const sfe_lsm_fifo_config_t &config, int8_t odrCalibration, bool queued,
+                                      uint32_t timeMs)
+{
+    uint8_t payload[kLSMLogConfigSize];
+
+    packConfig(config, odrCalibration, payload);
+
+    return writeRecord(queued ? LSM_LOG_CONFIG_QUEUED : LSM_LOG_CONFIG, payload, sizeof(payload), timeMs);
+}
+
+/// @brief Lays out decoder settings as in a LSM_LOG_CONFIG record.
+/// @param config The full scales and batch rates.
+/// @param odrCalibration The ODR calibration.
+/// @param payload Receives the 12 payload bytes.
+void SfeLSMFifoLogWriter::packConfig(const sfe_lsm_fifo_config_t &config, int8_t odrCalibration,
+                                     uint8_t payload[kLSMLogConfigSize])
+{
+    uint32_t bits;
+
+    payload[0] = (uint8_t)config.accelScale;
+    payload[1] = (uint8_t)config.gyroScale;
+    payload[2] = (uint8_t)odrCalibration;
+    payload[3] = 0;
+    memcpy(&bits, &config.accelBatchHz, sizeof(bits));
+    putLE32(&payload[4], bits);
+    memcpy(&bits, &config.gyroBatchHz, sizeof(bits));
+    putLE32(&payload[8], bits);
+}
+
+/// @brief Logs that the FIFO was emptied, e.g. by bypass mode, so the replay
+/// does not join the words before and after it.
+/// @param timeMs Time of the reset.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoLogWriter::writeReset(uint32_t timeMs)
+{
+    return writeRecord(LSM_LOG_FIFO_RESET, nullptr, 0, timeMs);
+}
+
+/// @brief Logs a new scale for the words of one sensor hub slot.
+/// @param slot The sensor hub slot, 0 - 3
+/// @param scale Units per LSB
+/// @param timeMs Time of the change.
+/// @return True if the sink took all bytes.
+bool SfeLSMFifoLogWriter::writeHubScale(uint8_t slot, float scale, uint32_t timeMs)
+{
+    uint8_t payload[kLSMLogHubScaleSize] = {0};
+    uint32_t bits;
+
+    if (slot > 3)
+        return false;
+
+    payload[0] = slot;
+    memcpy(&bits, &scale, sizeof(bits));
+    putLE32(&payload[4], bits);
+
+    return writeRecord(LSM_LOG_HUB_SCALE, payload, sizeof(payload), timeMs);
+}
+
+/// @brief Returns the number of bytes the sink took since begin().
+/// @return Bytes written
+uint32_t SfeLSMFifoLogWriter::getBytesWritten()
+{
+    return bytesWritten;
+}
+
+/// @brief Returns the number of writes the sink did not take in full. The log
+/// is damaged from the first one on.
+/// @return Failed writes since begin()
+uint32_t SfeLSMFifoLogWriter::getWriteErrors()
+{
+    return writeErrors;
+}
+
+bool SfeLSMFifoLogWriter::writeRecord(uint8_t type, const uint8_t *payload, uint16_t length, uint32_t timeMs)
+{
+    uint8_t header[kLSMLogRecordHeaderSize];
+
+    header[0] = type;
+    header[1] = 0;
+    putLE16(&header[2], length);
+    putLE32(&header[4], timeMs);
+
+    if (!put(header, sizeof(header)))
+        return false;
+
+    return length == 0 || put(payload, length);
+}
+
+bool SfeLSMFifoLogWriter::put(const uint8_t *data, size_t length)
+{
+    if (sink == nullptr)
+        return false;
+
+    size_t written = sink(data, length, context);
+
+    bytesWritten += written;
+
+    if (written != length)
+    {
+        writeErrors++;
+        return false;
+    }
+
+    return true;
+}
+
+SfeLSMFifoLogReader::SfeLSMFifoLogReader()
+    : data{nullptr}, length{0}, position{0}, version{0}, recordHeaderSize{0}, truncated{false}
+{
+}
+
+/// @brief Checks the file header of a log held in memory, e.g. a memory
+/// mapped file, and positions the reader on the first record.
+/// @param data The log, it has to stay valid while the reader is used.
+/// @param length The log size in bytes.
+/// @return True if the header is one of a log this reader understands.
+bool SfeLSMFifoLogReader::open(const uint8_t *data, size_t length)
+{
+    this->data = nullptr;
+
+    if (data == nullptr || length < kLSMLogHeaderSize || memcmp(data, kLogMagic, sizeof(kLogMagic)) != 0)
+        return false;
+
+    version = getLE16(&data[4]);
+    recordHeaderSize = data[6];
+
+    // Version 1 readers take newer logs as long as the words and record headers are laid out alike.
+    if (version < 1 || recordHeaderSize < kLSMLogRecordHeaderSize || data[7] != sizeof(sfe_lsm_fifo_word_t))
+        return false;
+
+    this->data = data;
+    this->length = length;
+    rewind();
+
+    return true;
+}
+
+/// @brief Moves the reader back to the first record.
+void SfeLSMFifoLogReader::rewind()
+{
+    position = kLSMLogHeaderSize;
+    truncated = false;
+}
+
+/// @brief Reads the next record. The payload is not copied, it points into the log.
+/// @param record Filled with the record.
+/// @return False at the end of the log or at a record cut short.
+bool SfeLSMFifoLogReader::next(sfe_lsm_log_record_t *record)
+{
+    if (data == nullptr || length - position < recordHeaderSize)
+    {
+        truncated = (data != nullptr && position != length);
+        return false;
+    }
+
+    const uint8_t *header = &data[position];
+    uint16_t payloadLength = getLE16(&header[2]);
+
+    if (length - position - recordHeaderSize < payloadLength)
+    {
+        truncated = true;
+        return false;
+    }
+
+    record->type = header[0];
+    record->length = payloadLength;
+    record->timeMs = getLE32(&header[4]);
+    record->payload = header + recordHeaderSize;
+
+    position += recordHeaderSize + payloadLength;
+
+    return true;
+}
+
+/// @brief Decodes the settings of a LSM_LOG_CONFIG or LSM_LOG_CONFIG_QUEUED record.
+/// @param record The record.
+/// @param config Set to the full scales and batch rates.
+/// @param odrCalibration Set to the ODR calibration.
+/// @return False if the record holds no settings.
+bool SfeLSMFifoLogReader::parseConfig(const sfe_lsm_log_record_t &record, sfe_lsm_fifo_config_t *config,
+                                      int8_t *odrCalibration)
+{
+    if ((record.type != LSM_LOG_CONFIG && record.type != LSM_LOG_CONFIG_QUEUED) || record.length < kLSMLogConfigSize)
+        return false;
+
+    unpackConfig(record.payload, config, odrCalibration);
+
+    return true;
+}
+
+/// @brief Reads decoder settings laid out as in a LSM_LOG_CONFIG record.
+/// @param payload The 12 payload bytes.
+/// @param config Set to the full scales and batch rates.
+/// @param odrCalibration Set to the ODR calibration.
+void SfeLSMFifoLogReader::unpackConfig(const uint8_t payload[kLSMLogConfigSize], sfe_lsm_fifo_config_t *config,
+                                       int8_t *odrCalibration)
+{
+    uint32_t bits;
+
+    config->accelScale = (lsm6dsv16x_xl_full_scale_t)payload[0];
+    config->gyroScale = (lsm6dsv16x_gy_full_scale_t)payload[1];
+    *odrCalibration = (int8_t)payload[2];
+    bits = getLE32(&payload[4]);
+    memcpy(&config->accelBatchHz, &bits, sizeof(bits));
+    bits = getLE32(&payload[8]);
+    memcpy(&config->gyroBatchHz, &bits, sizeof(bits));
+}
+
+/// @brief Replays the records from the current position to the end of the log
+/// through a decoder, whose handlers receive the samples.
+/// @param decoder The decoder, with its handlers registered.
+/// @return The number of FIFO words decoded.
+uint64_t SfeLSMFifoLogReader::replay(SfeLSMFifoDecoder &decoder)
+{
+    sfe_lsm_log_record_t record;
+    sfe_lsm_fifo_config_t config;
+    int8_t odrCalibration;
+    uint64_t words = 0;
+
+    while (next(&record))
+    {
+        switch (record.type)
+        {
+        case LSM_LOG_FIFO_WORDS: {
+            uint16_t count = record.length / sizeof(sfe_lsm_fifo_word_t);
+
+            decoder.decode((const sfe_lsm_fifo_word_t *)record.payload, count);
+            words += count;
+            break;
+        }
+        case LSM_LOG_CONFIG:
+        case LSM_LOG_CONFIG_QUEUED:
+            if (!parseConfig(record, &config, &odrCalibration))
+                break;
+
+            decoder.setOdrCalibration(odrCalibration);
+            if (record.type == LSM_LOG_CONFIG)
+                decoder.setConfig(config);
+            else
+                decoder.queueConfig(config);
+            break;
+        case LSM_LOG_FIFO_RESET:
+            decoder.reset();
+            break;
+        case LSM_LOG_HUB_SCALE: {
+            if (record.length < kLSMLogHubScaleSize)
+                break;
+
+            uint32_t bits = getLE32(&record.payload[4]);
+            float scale;
+
+            memcpy(&scale, &bits, sizeof(scale));
+            decoder.setSensorHubScale(record.payload[0], scale);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    return words;
+}
+
+/// @brief Returns the format version of the open log.
+/// @return The version, zero if no log is open.
+uint16_t SfeLSMFifoLogReader::getVersion()
+{
+    return (data != nullptr) ? version : 0;
+}
+
+/// @brief Tells whether reading stopped at a record that was cut short, as
+/// when the logger lost power.
+/// @return True if the log ends inside a record.
+bool SfeLSMFifoLogReader::isTruncated()
+{
+    return truncated;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+// Binary log of raw FIFO words. The writer streams the words read from the
+// device together with the decoder settings in effect to any byte sink, e.g.
+// an SD card file. The reader walks a log held in memory and replays it
+// through SfeLSMFifoDecoder, so a host can decode it exactly as the device
+// would have. See extras/fifo_log_replay for a host tool.
+//
+// Layout, all fields little endian:
+//
+//   File header, 16 bytes
+//     0  char[4]  "LSMF"
+//     4  uint16   Format version, kLSMLogVersion
+//     6  uint8    Record header size, 8
+//     7  uint8    FIFO word size, 7
+//     8  uint8    WHO_AM_I of the device, 0x70
+//     9  uint8[7] Reserved, zero
+//
+//   Records, each an 8 byte header followed by its payload
+//     0  uint8    Record type, sfe_lsm_log_record_type_t
+//     1  uint8    Reserved, zero
+//     2  uint16   Payload length in bytes
+//     4  uint32   Time in milliseconds, as given to the writer
+//
+//   LSM_LOG_FIFO_WORDS      Payload is the FIFO words as read, 7 bytes each
+//   LSM_LOG_CONFIG          Settings that apply from here on, 12 bytes:
+//   LSM_LOG_CONFIG_QUEUED   settings that apply from the next CFG_CHANGE word
+//     0  uint8    Accelerometer full scale, lsm6dsv16x_xl_full_scale_t
+//     1  uint8    Gyroscope full scale, lsm6dsv16x_gy_full_scale_t
+//     2  int8     ODR calibration, INTERNAL_FREQ
+//     3  uint8    Reserved, zero
+//     4  float32  Accelerometer batch rate in Hz
+//     8  float32  Gyroscope batch rate in Hz
+//   LSM_LOG_FIFO_RESET      The FIFO was emptied, no payload
+//   LSM_LOG_HUB_SCALE       Sensor hub scale that applies from here on, 8 bytes:
+//     0  uint8    Sensor hub slot, 0 - 3
+//     1  uint8[3] Reserved, zero
+//     4  float32  Units per LSB, see SfeLSMFifoDecoder::setSensorHubScale()
+//
+// Readers skip record types they do not know. Later versions may append
+// fields to a payload, readers use the fields they know.
+
+#include "sfe_lsm_fifo.h"
+#include <stddef.h>
+
+#define kLSMLogVersion 1
+#define kLSMLogHeaderSize 16
+#define kLSMLogRecordHeaderSize 8
+#define kLSMLogConfigSize 12
+#define kLSMLogHubScaleSize 8
+
+typedef enum
+{
+    LSM_LOG_FIFO_WORDS = 0x01,
+    LSM_LOG_CONFIG,
+    LSM_LOG_CONFIG_QUEUED,
+    LSM_LOG_FIFO_RESET,
+    LSM_LOG_HUB_SCALE
+} sfe_lsm_log_record_type_t;
+
+struct sfe_lsm_log_record_t
+{
+    uint8_t type;           // sfe_lsm_log_record_type_t
+    uint16_t length;        // Payload length in bytes
+    uint32_t timeMs;        // Time given to the writer
+    const uint8_t *payload; // Points into the log
+};
+
+// Receives the log bytes, returns how many it took.
+typedef size_t (*sfe_lsm_log_sink_t)(const uint8_t *data, size_t length, void *context);
+
+#ifdef ARDUINO
+class Print;
+#endif
+
+class SfeLSMFifoLogWriter
+{
+  public:
+    SfeLSMFifoLogWriter();
+
+    bool begin(sfe_lsm_log_sink_t sink, void *context, SfeLSMFifoDecoder &decoder, uint32_t timeMs = 0);
+#ifdef ARDUINO
+    bool begin(Print &out, SfeLSMFifoDecoder &decoder, uint32_t timeMs = 0);
+#endif
+    bool writeWords(const sfe_lsm_fifo_word_t *words, uint16_t count, uint32_t timeMs = 0);
+    bool writeConfig(const sfe_lsm_fifo_config_t &config, int8_t odrCalibration, bool queued = false,
+                     uint32_t timeMs = 0);
+    bool writeReset(uint32_t timeMs = 0);
+    bool writeHubScale(uint8_t slot, float scale, uint32_t timeMs = 0);
+
+    uint32_t getBytesWritten();
+    uint32_t getWriteErrors();
+
+    static void packConfig(const sfe_lsm_fifo_config_t &config, int8_t odrCalibration,
+                           uint8_t payload[kLSMLogConfigSize]);
+
+  private:
+    bool writeRecord(uint8_t type, const uint8_t *payload, uint16_t length, uint32_t timeMs);
+    bool put(const uint8_t *data, size_t length);
+
+    sfe_lsm_log_sink_t sink;
+    void *context;
+    uint32_t bytesWritten;
+    uint32_t writeErrors;
+};
+
+class SfeLSMFifoLogReader
+{
+  public:
+    SfeLSMFifoLogReader();
+
+    bool open(const uint8_t *data, size_t length);
+    bool next(sfe_lsm_log_record_t *record);
+    void rewind();
+    uint64_t replay(SfeLSMFifoDecoder &decoder);
+
+    static bool parseConfig(const sfe_lsm_log_record_t &record, sfe_lsm_fifo_config_t *config,
+                            int8_t *odrCalibration);
+    static void unpackConfig(const uint8_t payload[kLSMLogConfigSize], sfe_lsm_fifo_config_t *config,
+                             int8_t *odrCalibration);
+
+    uint16_t getVersion();
+    bool isTruncated();
+
+  private:
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    uint16_t version;
+    uint8_t recordHeaderSize;
+    bool truncated;
+};
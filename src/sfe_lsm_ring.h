@@ -0,0 +1,220 @@
+#pragma once
+
+// Fixed capacity ring buffer for handing samples from an interrupt handler or
+// a high priority task to the main loop, without locks. Exactly one producer
+// may call the push/reserve/commit side and exactly one consumer the
+// pop/peek/release side; each side only writes its own index. The storage is
+// part of the object, so a global ring is statically allocated.
+//
+// Nothing in here touches the bus or the Arduino core, so the ring builds on
+// a host as well. See QwDevLSM6DSV16X::readRawAccel(), readAccel() and
+// readFifoBatch() for the acquisition routines that fill it.
+
+#include "sfe_lsm_fifo.h"
+
+// Indexes are read and written in one access by the other side. On 8 bit
+// parts only a byte is, which limits the capacity there to 128.
+#if defined(__AVR__)
+typedef uint8_t sfe_lsm_ring_index_t;
+#else
+typedef uint32_t sfe_lsm_ring_index_t;
+#endif
+
+// Keeps the producer and the consumer index on separate cache lines where
+// both sides may run on different cores. Microcontrollers run them on one
+// core, there it only costs RAM.
+#ifndef SFE_LSM_RING_CACHE_LINE
+#if defined(ARDUINO)
+#define SFE_LSM_RING_CACHE_LINE 4
+#else
+#define SFE_LSM_RING_CACHE_LINE 64
+#endif
+#endif
+
+// Orders the slot access against the index update. On Cortex-M this is a DMB,
+// elsewhere at least a compiler barrier.
+#if defined(__arm__) || defined(__aarch64__) || defined(__x86_64__) || defined(__i386__) || defined(__XTENSA__) ||  \
+    defined(__riscv)
+#define SFE_LSM_RING_BARRIER() __sync_synchronize()
+#else
+#define SFE_LSM_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+// One sensor reading with the time it was taken, in micros().
+struct sfe_lsm_raw_sample_t
+{
+    uint32_t timeUs;
+    sfe_lsm_raw_data_t data;
+};
+
+struct sfe_lsm_sample_t
+{
+    uint32_t timeUs;
+    sfe_lsm_data_t data;
+};
+
+template <class T, uint16_t N> class SfeLSMRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Ring capacity must be a power of two");
+    static_assert((uint32_t)N <= (uint32_t)(sfe_lsm_ring_index_t)~0u / 2 + 1, "Ring capacity too large for this part");
+
+  public:
+    SfeLSMRing() : head{0}, overflows{0}, tail{0}
+    {
+    }
+
+    /// @brief Producer: copies a sample in.
+    /// @param item The sample.
+    /// @return False if the ring is full, the sample is dropped and counted.
+    bool push(const T &item)
+    {
+        T *slot = reserve();
+
+        if (slot == nullptr)
+            return false;
+
+        *slot = item;
+        commit();
+
+        return true;
+    }
+
+    /// @brief Producer: returns the next free slot to be filled in place, e.g.
+    /// by a bus read. The slot is handed to the consumer by commit().
+    /// @return The slot, or nullptr if the ring is full, which is counted.
+    T *reserve()
+    {
+        sfe_lsm_ring_index_t h = head;
+
+        if ((sfe_lsm_ring_index_t)(h - tail) >= N)
+        {
+            overflows++;
+            return nullptr;
+        }
+
+        return &items[h & (N - 1)];
+    }
+
+    /// @brief Producer: returns all free slots to be filled in one go, as the
+    /// run up to the end of the storage and the run wrapped to its start.
+    /// @param first Set to the first free slot.
+    /// @param firstCount Set to the number of slots in the first run.
+    /// @param second Set to the start of the storage.
+    /// @param secondCount Set to the number of slots in the wrapped run.
+    /// @return The number of free slots, zero if the ring is full.
+    uint16_t reserveSpan(T **first, uint16_t *firstCount, T **second, uint16_t *secondCount)
+    {
+        sfe_lsm_ring_index_t h = head;
+        uint16_t space = N - (uint16_t)(sfe_lsm_ring_index_t)(h - tail);
+        uint16_t toEnd = N - (uint16_t)(h & (N - 1));
+
+        *first = &items[h & (N - 1)];
+        *firstCount = (space < toEnd) ? space : toEnd;
+        *second = &items[0];
+        *secondCount = space - *firstCount;
+
+        return space;
+    }
+
+    /// @brief Producer: hands filled slots to the consumer.
+    /// @param count The number of slots filled since the last commit.
+    void commit(uint16_t count = 1)
+    {
+        SFE_LSM_RING_BARRIER();
+        head = head + count;
+    }
+
+    /// @brief Consumer: copies the oldest sample out.
+    /// @param item Set to the sample.
+    /// @return False if the ring is empty.
+    bool pop(T *item)
+    {
+        const T *slot = peek();
+
+        if (slot == nullptr)
+            return false;
+
+        *item = *slot;
+        release();
+
+        return true;
+    }
+
+    /// @brief Consumer: returns the oldest sample in place. It stays valid
+    /// until release().
+    /// @return The sample, or nullptr if the ring is empty.
+    const T *peek()
+    {
+        sfe_lsm_ring_index_t t = tail;
+
+        if (head == t)
+            return nullptr;
+
+        SFE_LSM_RING_BARRIER();
+
+        return &items[t & (N - 1)];
+    }
+
+    /// @brief Consumer: returns the samples that follow each other in memory,
+    /// up to the end of the storage, e.g. to decode a run of FIFO words.
+    /// @param count Set to the number of samples, zero if the ring is empty.
+    /// @return The oldest sample.
+    const T *peekContiguous(uint16_t *count)
+    {
+        sfe_lsm_ring_index_t t = tail;
+        uint16_t used = (uint16_t)(sfe_lsm_ring_index_t)(head - t);
+        uint16_t toEnd = N - (uint16_t)(t & (N - 1));
+
+        *count = (used < toEnd) ? used : toEnd;
+        SFE_LSM_RING_BARRIER();
+
+        return &items[t & (N - 1)];
+    }
+
+    /// @brief Consumer: frees samples taken with peek() or peekContiguous().
+    /// @param count The number of samples.
+    void release(uint16_t count = 1)
+    {
+        SFE_LSM_RING_BARRIER();
+        tail = tail + count;
+    }
+
+    /// @brief Returns the number of samples waiting. Exact on the consumer side,
+    /// the producer may add more at any time.
+    /// @return Samples in the ring
+    uint16_t available()
+    {
+        return (uint16_t)(sfe_lsm_ring_index_t)(head - tail);
+    }
+
+    /// @brief Returns the number of samples dropped because the ring was full.
+    /// @return Overflows since construction or the last resetOverflows()
+    uint32_t getOverflows()
+    {
+        return overflows;
+    }
+
+    /// @brief Clears the overflow count. Call it from the producer side, or
+    /// with the producer stopped.
+    void resetOverflows()
+    {
+        overflows = 0;
+    }
+
+    /// @brief Returns the capacity in samples.
+    /// @return The capacity
+    static constexpr uint16_t capacity()
+    {
+        return N;
+    }
+
+  private:
+    // Written by the producer only
+    alignas(SFE_LSM_RING_CACHE_LINE) volatile sfe_lsm_ring_index_t head;
+    volatile uint32_t overflows;
+
+    // Written by the consumer only
+    alignas(SFE_LSM_RING_CACHE_LINE) volatile sfe_lsm_ring_index_t tail;
+
+    alignas(SFE_LSM_RING_CACHE_LINE) T items[N];
+};
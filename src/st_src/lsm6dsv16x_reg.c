@@ -3715,12 +3715,23 @@ int32_t lsm6dsv16x_fifo_timestamp_batch_get(stmdev_ctx_t *ctx,
 int32_t lsm6dsv16x_fifo_batch_counter_threshold_set(stmdev_ctx_t *ctx,
                                                     uint16_t val)
 {
+  lsm6dsv16x_counter_bdr_reg1_t counter_bdr_reg1;
+  lsm6dsv16x_counter_bdr_reg2_t counter_bdr_reg2;
   uint8_t buff[2];
   int32_t ret;
 
-  buff[1] = (uint8_t)(val / 256U);
-  buff[0] = (uint8_t)(val - (buff[1] * 256U));
-  ret = lsm6dsv16x_write_reg(ctx, LSM6DSV16X_COUNTER_BDR_REG1, (uint8_t *)&buff[0], 2);
+  /* REG1 holds TH[9:8] next to the trigger selection, REG2 holds TH[7:0] */
+  ret = lsm6dsv16x_read_reg(ctx, LSM6DSV16X_COUNTER_BDR_REG1, buff, 2);
+  if (ret == 0)
+  {
+    bytecpy((uint8_t *)&counter_bdr_reg1, &buff[0]);
+    bytecpy((uint8_t *)&counter_bdr_reg2, &buff[1]);
+    counter_bdr_reg1.cnt_bdr_th = (uint8_t)((val >> 8) & 0x03U);
+    counter_bdr_reg2.cnt_bdr_th = (uint8_t)(val & 0xFFU);
+    bytecpy(&buff[0], (uint8_t *)&counter_bdr_reg1);
+    bytecpy(&buff[1], (uint8_t *)&counter_bdr_reg2);
+    ret = lsm6dsv16x_write_reg(ctx, LSM6DSV16X_COUNTER_BDR_REG1, buff, 2);
+  }
 
   return ret;
 }
@@ -3736,12 +3747,14 @@ int32_t lsm6dsv16x_fifo_batch_counter_threshold_set(stmdev_ctx_t *ctx,
 int32_t lsm6dsv16x_fifo_batch_counter_threshold_get(stmdev_ctx_t *ctx,
                                                     uint16_t *val)
 {
+  lsm6dsv16x_counter_bdr_reg1_t counter_bdr_reg1;
   uint8_t buff[2];
   int32_t ret;
 
   ret = lsm6dsv16x_read_reg(ctx, LSM6DSV16X_COUNTER_BDR_REG1, &buff[0], 2);
-  *val = buff[1];
-  *val = (*val * 256U) + buff[0];
+  bytecpy((uint8_t *)&counter_bdr_reg1, &buff[0]);
+  *val = counter_bdr_reg1.cnt_bdr_th;
+  *val = (*val * 256U) + buff[1];
 
   return ret;
 }